@@ -0,0 +1,127 @@
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "PluginEditor.h"
+#include "PluginProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Editor paint cost while a knob is dragged, with and without the cached static layer.
+//
+//     DualToneGeneratorPaintBench [--frames 600] [--out results.json]
+//
+// At the smallest and largest editor size, every dial is dragged across its range in turn.
+// Each frame moves the dial and repaints the region its repaint would invalidate, the way the
+// host's window would. The report gives the median and 99th percentile microseconds per frame
+// for the direct paint and for the cached static layer.
+namespace
+{
+struct PaintResult
+{
+    double medianMicroseconds = 0.0;
+    double p99Microseconds = 0.0;
+};
+
+PaintResult measureDrags(DualToneGeneratorAudioProcessorEditor& editor, int numFrames)
+{
+    std::vector<juce::Slider*> sliders;
+
+    for (auto* child : editor.getChildren())
+        if (auto* slider = dynamic_cast<juce::Slider*>(child))
+            sliders.push_back(slider);
+
+    juce::Image target(juce::Image::RGB, editor.getWidth(), editor.getHeight(), true);
+    std::vector<double> timings;
+
+    // One untimed frame builds the caches the cached configuration depends on
+    {
+        juce::Graphics g(target);
+        editor.paintEntireComponent(g, false);
+    }
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        auto* slider = sliders[static_cast<size_t>(frame) % sliders.size()];
+        const auto position = static_cast<double>(frame % 97) / 96.0;
+        slider->setValue(slider->proportionOfLengthToValue(position), juce::sendNotificationSync);
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            juce::Graphics g(target);
+            g.reduceClipRegion(slider->getBounds());
+            editor.paintEntireComponent(g, false);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        timings.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) * 1.0e-3);
+    }
+
+    std::sort(timings.begin(), timings.end());
+
+    PaintResult result;
+    result.medianMicroseconds = timings[timings.size() / 2];
+    result.p99Microseconds = timings[juce::jmin(timings.size() - 1, timings.size() * 99 / 100)];
+    return result;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList arguments(argc, argv);
+    const auto framesText = arguments.getValueForOption("--frames");
+    const auto numFrames = juce::jmax(10, framesText.isNotEmpty() ? framesText.getIntValue() : 600);
+    const auto outputPath = arguments.getValueForOption("--out");
+
+    DualToneGeneratorAudioProcessor processor;
+    std::unique_ptr<DualToneGeneratorAudioProcessorEditor> editor(
+        dynamic_cast<DualToneGeneratorAudioProcessorEditor*>(processor.createEditor()));
+
+    auto* cases = new juce::DynamicObject();
+    auto* constrainer = editor->getConstrainer();
+
+    const struct
+    {
+        const char* name;
+        int width;
+        int height;
+    } sizes[] = { { "min", constrainer->getMinimumWidth(), constrainer->getMinimumHeight() },
+                  { "max", constrainer->getMaximumWidth(), constrainer->getMaximumHeight() } };
+
+    for (const auto& size : sizes)
+    {
+        editor->setSize(size.width, size.height);
+
+        for (auto cached : { false, true })
+        {
+            editor->setStaticLayerCachingEnabled(cached);
+            const auto result = measureDrags(*editor, numFrames);
+            const auto name = juce::String(size.name) + "/" + (cached ? "cached" : "direct");
+
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("medianMicroseconds", result.medianMicroseconds);
+            entry->setProperty("p99Microseconds", result.p99Microseconds);
+            cases->setProperty(name, juce::var(entry));
+
+            std::cerr << name << " (" << size.width << "x" << size.height << "): median " << result.medianMicroseconds
+                      << " us, p99 " << result.p99Microseconds << " us per frame\n";
+        }
+    }
+
+    editor = nullptr;
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("benchmark", "DualToneGeneratorPaintBench");
+    root->setProperty("frames", numFrames);
+    root->setProperty("cases", juce::var(cases));
+    const auto json = juce::JSON::toString(juce::var(root));
+
+    if (outputPath.isNotEmpty())
+        juce::File::getCurrentWorkingDirectory().getChildFile(outputPath).replaceWithText(json);
+    else
+        std::cout << json << "\n";
+
+    return 0;
+}
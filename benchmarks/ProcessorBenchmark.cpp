@@ -0,0 +1,222 @@
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "PluginProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Throughput of DualToneGeneratorAudioProcessor::processBlock across host configurations.
+//
+//     DualToneGeneratorBench [--quick] [--filter <text>] [--out results.json]
+//                            [--compare baseline.json] [--threshold 0.1]
+//
+// Every case runs the processor in non-realtime mode, so it always synthesises live and
+// never plays from the periodic render cache. Results are written as JSON, keyed by case
+// name. With --compare, any case whose ns/sample exceeds the baseline's by more than the
+// threshold (a fraction, default 0.1) is reported and the exit code is 1.
+namespace
+{
+struct ShapeSetting
+{
+    const char* name;
+    float driveDb;
+    float shapeType;
+};
+
+struct BenchmarkCase
+{
+    bool doublePrecision = false;
+    int numChannels = 2;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    ShapeSetting shape {};
+
+    juce::String getName() const
+    {
+        return juce::String(doublePrecision ? "double" : "float") + "/" + (numChannels == 1 ? "mono" : "stereo") + "/"
+               + juce::String(juce::roundToInt(sampleRate)) + "/" + juce::String(blockSize) + "/" + shape.name;
+    }
+};
+
+struct BenchmarkResult
+{
+    double nanosecondsPerSample = 0.0;
+    double instancesPerCore = 0.0;
+};
+
+// Audio time measured per repetition; the median of the repetitions is reported.
+constexpr int samplesPerRepetition = 1 << 16;
+constexpr int numRepetitions = 5;
+
+template <typename SampleType>
+double timeRepetition(DualToneGeneratorAudioProcessor& processor, juce::AudioBuffer<SampleType>& buffer, int numBlocks)
+{
+    juce::MidiBuffer midi;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int block = 0; block < numBlocks; ++block)
+        processor.processBlock(buffer, midi);
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+template <typename SampleType>
+BenchmarkResult runCase(const BenchmarkCase& benchmarkCase)
+{
+    DualToneGeneratorAudioProcessor processor;
+    auto& params = processor.getValueTreeState();
+    *params.getRawParameterValue("centerFreq") = 440.0f;
+    *params.getRawParameterValue("spread") = 3.0f;
+    *params.getRawParameterValue("drive") = benchmarkCase.shape.driveDb;
+    *params.getRawParameterValue("shapeType") = benchmarkCase.shape.shapeType;
+
+    processor.setNonRealtime(true);
+    processor.setProcessingPrecision(benchmarkCase.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                   : juce::AudioProcessor::singlePrecision);
+    processor.setPlayConfigDetails(0, benchmarkCase.numChannels, benchmarkCase.sampleRate, benchmarkCase.blockSize);
+    processor.prepareToPlay(benchmarkCase.sampleRate, benchmarkCase.blockSize);
+
+    juce::AudioBuffer<SampleType> buffer(benchmarkCase.numChannels, benchmarkCase.blockSize);
+    const auto numBlocks = juce::jmax(8, samplesPerRepetition / benchmarkCase.blockSize);
+
+    // One untimed repetition builds the shaper table and warms the caches
+    timeRepetition(processor, buffer, numBlocks);
+
+    std::vector<double> timings;
+
+    for (int repetition = 0; repetition < numRepetitions; ++repetition)
+        timings.push_back(timeRepetition(processor, buffer, numBlocks));
+
+    std::sort(timings.begin(), timings.end());
+
+    BenchmarkResult result;
+    result.nanosecondsPerSample = timings[timings.size() / 2] / static_cast<double>(numBlocks * benchmarkCase.blockSize);
+
+    // How many instances one core could run in real time at this sample rate
+    result.instancesPerCore = (1.0e9 / benchmarkCase.sampleRate) / result.nanosecondsPerSample;
+    return result;
+}
+
+std::vector<BenchmarkCase> makeCases(bool quick)
+{
+    const std::vector<int> blockSizes = quick ? std::vector<int> { 64, 512, 4096 }
+                                              : std::vector<int> { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+    const std::vector<double> sampleRates = quick ? std::vector<double> { 48000.0, 192000.0 }
+                                                  : std::vector<double> { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0, 384000.0 };
+    const std::vector<ShapeSetting> shapes { { "clean", -24.0f, 0.0f },
+                                             { "tanh", 12.0f, 0.0f },
+                                             { "blend", 6.0f, 0.5f },
+                                             { "atan", 12.0f, 1.0f } };
+
+    std::vector<BenchmarkCase> cases;
+
+    for (auto doublePrecision : { false, true })
+        for (auto numChannels : { 1, 2 })
+            for (auto sampleRate : sampleRates)
+                for (auto blockSize : blockSizes)
+                    for (const auto& shape : shapes)
+                        cases.push_back({ doublePrecision, numChannels, sampleRate, blockSize, shape });
+
+    return cases;
+}
+
+// Lists every case slower than its baseline by more than the threshold; returns how many there were.
+int compareWithBaseline(const juce::var& results, const juce::var& baseline, double threshold)
+{
+    auto regressions = 0;
+    auto compared = 0;
+
+    if (auto* baselineCases = baseline["cases"].getDynamicObject())
+    {
+        for (const auto& entry : baselineCases->getProperties())
+        {
+            const auto current = results["cases"][entry.name];
+
+            if (current.isVoid())
+                continue;
+
+            const auto before = static_cast<double>(entry.value["nsPerSample"]);
+            const auto after = static_cast<double>(current["nsPerSample"]);
+            ++compared;
+
+            if (before > 0.0 && after > before * (1.0 + threshold))
+            {
+                ++regressions;
+                std::cerr << "REGRESSION " << entry.name.toString() << ": " << before << " -> " << after << " ns/sample (+"
+                          << juce::roundToInt((after / before - 1.0) * 100.0) << "%)\n";
+            }
+        }
+    }
+
+    std::cerr << compared << " cases compared, " << regressions << " regressed by more than "
+              << juce::roundToInt(threshold * 100.0) << "%\n";
+    return regressions;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList arguments(argc, argv);
+    const auto quick = arguments.containsOption("--quick");
+    const auto filter = arguments.getValueForOption("--filter");
+    const auto outputPath = arguments.getValueForOption("--out");
+    const auto baselinePath = arguments.getValueForOption("--compare");
+    const auto thresholdText = arguments.getValueForOption("--threshold");
+    const auto threshold = thresholdText.isNotEmpty() ? thresholdText.getDoubleValue() : 0.1;
+
+    juce::var baseline;
+
+    if (baselinePath.isNotEmpty())
+    {
+        baseline = juce::JSON::parse(juce::File::getCurrentWorkingDirectory().getChildFile(baselinePath));
+
+        if (! baseline.isObject())
+        {
+            std::cerr << "DualToneGeneratorBench: cannot read baseline " << baselinePath << "\n";
+            return 2;
+        }
+    }
+
+    auto* cases = new juce::DynamicObject();
+
+    for (const auto& benchmarkCase : makeCases(quick))
+    {
+        const auto name = benchmarkCase.getName();
+
+        if (filter.isNotEmpty() && ! name.contains(filter))
+            continue;
+
+        const auto result = benchmarkCase.doublePrecision ? runCase<double>(benchmarkCase) : runCase<float>(benchmarkCase);
+
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("nsPerSample", result.nanosecondsPerSample);
+        entry->setProperty("instancesPerCore", result.instancesPerCore);
+        cases->setProperty(name, juce::var(entry));
+
+        std::cerr << name << ": " << result.nanosecondsPerSample << " ns/sample, " << result.instancesPerCore
+                  << " instances/core\n";
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("benchmark", "DualToneGeneratorBench");
+    root->setProperty("quick", quick);
+    root->setProperty("cases", juce::var(cases));
+    const juce::var results(root);
+
+    const auto json = juce::JSON::toString(results);
+
+    if (outputPath.isNotEmpty())
+        juce::File::getCurrentWorkingDirectory().getChildFile(outputPath).replaceWithText(json);
+    else
+        std::cout << json << "\n";
+
+    if (baseline.isObject())
+        return compareWithBaseline(results, baseline, threshold) > 0 ? 1 : 0;
+
+    return 0;
+}
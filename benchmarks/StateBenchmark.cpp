@@ -0,0 +1,168 @@
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "PluginProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+// State save, state load and preset switch latency.
+//
+//     DualToneGeneratorStateBench [--iterations 2000] [--out results.json]
+//
+// The processor holds a full 64-partial tone bank, the largest state it can save. Save and
+// load are timed for the binary format and for the XML format earlier versions wrote, which
+// loading still accepts. Switching is timed as the host's setCurrentProgram call, and as the
+// audio thread sees it: a 64-sample block that applies a requested preset against one that
+// does not. The report gives the median and 99th percentile microseconds per operation.
+namespace
+{
+struct Timing
+{
+    double medianMicroseconds = 0.0;
+    double p99Microseconds = 0.0;
+};
+
+Timing measure(int numIterations, const std::function<void(int)>& operation)
+{
+    std::vector<double> timings;
+    timings.reserve(static_cast<size_t>(numIterations));
+
+    // A few untimed runs settle allocations and caches
+    for (int iteration = 0; iteration < 8; ++iteration)
+        operation(iteration);
+
+    for (int iteration = 0; iteration < numIterations; ++iteration)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        operation(iteration);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        timings.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) * 1.0e-3);
+    }
+
+    std::sort(timings.begin(), timings.end());
+
+    Timing timing;
+    timing.medianMicroseconds = timings[timings.size() / 2];
+    timing.p99Microseconds = timings[juce::jmin(timings.size() - 1, timings.size() * 99 / 100)];
+    return timing;
+}
+
+ToneBankLayout makeFullBank()
+{
+    ToneBankLayout layout;
+    layout.numPartials = ToneBankLayout::maxPartials;
+
+    for (int partial = 0; partial < layout.numPartials; ++partial)
+    {
+        layout.offsetsHz[partial] = 3.0 * partial;
+        layout.levels[partial] = 1.0 / (1 + partial);
+        layout.pans[partial] = -1.0 + 2.0 * partial / (layout.numPartials - 1);
+    }
+
+    return layout;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList arguments(argc, argv);
+    const auto iterationsText = arguments.getValueForOption("--iterations");
+    const auto numIterations = juce::jmax(10, iterationsText.isNotEmpty() ? iterationsText.getIntValue() : 2000);
+    const auto outputPath = arguments.getValueForOption("--out");
+
+    DualToneGeneratorAudioProcessor processor;
+    processor.setToneBank(makeFullBank());
+    processor.getValueTreeState().getParameter("drive")->setValueNotifyingHost(0.75f);
+
+    juce::MemoryBlock binaryState;
+    processor.getStateInformation(binaryState);
+
+    juce::MemoryBlock xmlState;
+    if (auto xml = processor.getValueTreeState().copyState().createXml())
+        juce::AudioProcessor::copyXmlToBinary(*xml, xmlState);
+
+    // Two programs that differ in every parameter, so each switch moves everything
+    processor.addProgram("Bank");
+    processor.setToneBank({});
+    processor.getValueTreeState().getParameter("centerFreq")->setValueNotifyingHost(0.8f);
+    processor.addProgram("Pair");
+
+    processor.prepareToPlay(48000.0, 64);
+    juce::AudioBuffer<float> buffer(2, 64);
+    juce::MidiBuffer midi;
+
+    std::vector<std::pair<const char*, Timing>> results;
+
+    results.emplace_back("save/binary", measure(numIterations, [&](int)
+    {
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+    }));
+
+    results.emplace_back("save/xml", measure(numIterations, [&](int)
+    {
+        juce::MemoryBlock state;
+        if (auto xml = processor.getValueTreeState().copyState().createXml())
+            juce::AudioProcessor::copyXmlToBinary(*xml, state);
+    }));
+
+    results.emplace_back("load/binary", measure(numIterations, [&](int)
+    {
+        processor.setStateInformation(binaryState.getData(), static_cast<int>(binaryState.getSize()));
+    }));
+
+    results.emplace_back("load/xml", measure(numIterations, [&](int)
+    {
+        processor.setStateInformation(xmlState.getData(), static_cast<int>(xmlState.getSize()));
+    }));
+
+    results.emplace_back("switch/setCurrentProgram", measure(numIterations, [&](int iteration)
+    {
+        processor.setCurrentProgram(1 + iteration % 2);
+    }));
+
+    results.emplace_back("switch/block", measure(numIterations, [&](int iteration)
+    {
+        processor.getPresetBank().requestSwitch(1 + iteration % 2);
+        processor.processBlock(buffer, midi);
+    }));
+
+    results.emplace_back("hold/block", measure(numIterations, [&](int)
+    {
+        processor.processBlock(buffer, midi);
+    }));
+
+    auto* cases = new juce::DynamicObject();
+
+    for (const auto& [name, timing] : results)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("medianMicroseconds", timing.medianMicroseconds);
+        entry->setProperty("p99Microseconds", timing.p99Microseconds);
+        cases->setProperty(name, juce::var(entry));
+
+        std::cerr << name << ": median " << timing.medianMicroseconds << " us, p99 " << timing.p99Microseconds << " us\n";
+    }
+
+    std::cerr << "binary state " << binaryState.getSize() << " bytes, XML state " << xmlState.getSize() << " bytes\n";
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("benchmark", "DualToneGeneratorStateBench");
+    root->setProperty("iterations", numIterations);
+    root->setProperty("binaryStateBytes", static_cast<int>(binaryState.getSize()));
+    root->setProperty("xmlStateBytes", static_cast<int>(xmlState.getSize()));
+    root->setProperty("cases", juce::var(cases));
+    const auto json = juce::JSON::toString(juce::var(root));
+
+    if (outputPath.isNotEmpty())
+        juce::File::getCurrentWorkingDirectory().getChildFile(outputPath).replaceWithText(json);
+    else
+        std::cout << json << "\n";
+
+    return 0;
+}
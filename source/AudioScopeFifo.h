@@ -0,0 +1,143 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+// Wait-free single-producer/single-consumer ring that carries a decimated copy of the output
+// from the audio thread to the editor's scope.
+//
+// The audio thread mixes the front pair of output channels to mono, low-pass filters it below
+// the decimated Nyquist rate and keeps every decimation-th filtered sample, so tones above the
+// scope's band are removed rather than folded down onto it. The filter is only evaluated for
+// the samples that are kept. When the ring is full the audio thread drops samples rather than
+// waiting. Nothing is written unless a consumer has switched the FIFO on, so with the editor
+// closed a block costs one relaxed atomic load.
+class AudioScopeFifo
+{
+public:
+    // Ring capacity in decimated samples, about 1.4 s at the target rate.
+    static constexpr int capacity = 1 << 14;
+
+    // Rate the output is decimated to, close enough to see tones up to a few kHz.
+    static constexpr double targetSampleRate = 12000.0;
+
+    // Largest decimation factor; higher sample rates are decimated to above the target rate.
+    static constexpr int maxDecimation = 32;
+
+    // Filter taps per decimated sample. With a Blackman window everything from the decimated
+    // Nyquist rate up is at least 75 dB down, and the passband is flat to 0.1 dB up to a third
+    // of the decimated rate, 4 kHz at 12 kHz.
+    static constexpr int tapsPerOutput = 32;
+
+    // Message thread, while the audio thread is stopped.
+    void prepare(double sampleRate) noexcept
+    {
+        const auto factor = juce::jlimit(1, maxDecimation, static_cast<int>(sampleRate / targetSampleRate));
+        decimation = factor;
+        numTaps = factor > 1 ? tapsPerOutput * factor : 1;
+
+        // Windowed sinc with its cutoff at 0.4 of the decimated rate, scaled so the channel pair
+        // comes out at its mean
+        const auto cutoff = 0.4 / factor;
+        const auto centre = 0.5 * (numTaps - 1);
+        auto sum = 0.0;
+
+        for (int n = 0; n < numTaps; ++n)
+        {
+            const auto x = n - centre;
+            const auto sinc = x == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::twoPi * cutoff * x)
+                                                   / (juce::MathConstants<double>::twoPi * cutoff * x);
+            const auto phase = juce::MathConstants<double>::twoPi * n / juce::jmax(1, numTaps - 1);
+            const auto window = numTaps > 1 ? 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase) : 1.0;
+            taps[static_cast<size_t>(n)] = static_cast<float>(sinc * window);
+            sum += sinc * window;
+        }
+
+        for (int n = 0; n < numTaps; ++n)
+            taps[static_cast<size_t>(n)] *= static_cast<float>(0.5 / sum);
+
+        history.fill(0.0f);
+        historyIndex = 0;
+        accumulated = 0;
+        outputSampleRate.store(sampleRate / factor);
+    }
+
+    // Consumer: the producer only writes while this is on.
+    void setActive(bool shouldBeActive) noexcept { active.store(shouldBeActive); }
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    double getOutputSampleRate() const noexcept { return outputSampleRate.load(); }
+
+    // Audio thread.
+    template <typename SampleType>
+    void push(const juce::AudioBuffer<SampleType>& buffer) noexcept
+    {
+        if (! isActive() || buffer.getNumChannels() == 0)
+            return;
+
+        const auto* left = buffer.getReadPointer(0);
+        const auto* right = buffer.getReadPointer(juce::jmin(1, buffer.getNumChannels() - 1));
+        auto write = writeIndex.load(std::memory_order_relaxed);
+        const auto read = readIndex.load(std::memory_order_acquire);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            // The history is stored twice over, newest first, so the taps always read one contiguous run
+            historyIndex = historyIndex > 0 ? historyIndex - 1 : numTaps - 1;
+            const auto mono = static_cast<float>(left[i]) + static_cast<float>(right[i]);
+            history[static_cast<size_t>(historyIndex)] = mono;
+            history[static_cast<size_t>(historyIndex + numTaps)] = mono;
+
+            if (++accumulated < decimation)
+                continue;
+
+            accumulated = 0;
+
+            if (write - read < static_cast<std::uint32_t>(capacity))
+            {
+                const auto* newest = history.data() + historyIndex;
+                samples[write++ & mask] = std::inner_product(newest, newest + numTaps, taps.data(), 0.0f);
+            }
+        }
+
+        writeIndex.store(write, std::memory_order_release);
+    }
+
+    // Consumer: copies up to maxSamples of the oldest unread samples and returns how many.
+    int pop(float* destination, int maxSamples) noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        const auto available = writeIndex.load(std::memory_order_acquire) - read;
+        const auto count = static_cast<int>(juce::jmin(available, static_cast<std::uint32_t>(juce::jmax(0, maxSamples))));
+
+        for (int i = 0; i < count; ++i)
+            destination[i] = samples[(read + static_cast<std::uint32_t>(i)) & mask];
+
+        readIndex.store(read + static_cast<std::uint32_t>(count), std::memory_order_release);
+        return count;
+    }
+
+private:
+    static constexpr std::uint32_t mask = capacity - 1;
+
+    std::array<float, capacity> samples {};
+    std::atomic<std::uint32_t> writeIndex { 0 };
+    std::atomic<std::uint32_t> readIndex { 0 };
+    std::atomic<bool> active { false };
+    std::atomic<double> outputSampleRate { 44100.0 };
+
+    // Audio thread
+    static constexpr int maxTaps = tapsPerOutput * maxDecimation;
+
+    int decimation = 1;
+    int numTaps = 1;
+    std::array<float, maxTaps> taps { 0.5f };
+    std::array<float, 2 * maxTaps> history {};
+    int historyIndex = 0;
+    int accumulated = 0;
+};
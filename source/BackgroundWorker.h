@@ -0,0 +1,26 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Process-wide thread that rebuilds DSP lookup data off the audio thread.
+//
+// Shared between all processor instances through juce::SharedResourcePointer, so a
+// session with dozens of instances still only runs one worker. Clients are polled;
+// the audio thread never signals or waits on this thread.
+class BackgroundWorker : public juce::TimeSliceThread
+{
+public:
+    BackgroundWorker()
+        : juce::TimeSliceThread("Dual Tone Background Worker")
+    {
+        startThread();
+    }
+
+    ~BackgroundWorker() override
+    {
+        stopThread(2000);
+    }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BackgroundWorker)
+};
@@ -0,0 +1,151 @@
+#include "ChannelPanner.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr double pi = 3.141592653589793238462643383279502884;
+constexpr double halfPi = 0.5 * pi;
+constexpr double degreesToRadians = pi / 180.0;
+
+double factorial(int n) noexcept
+{
+    double result = 1.0;
+    for (int i = 2; i <= n; ++i)
+        result *= static_cast<double>(i);
+    return result;
+}
+
+double doubleFactorial(int n) noexcept
+{
+    double result = 1.0;
+    for (int i = n; i > 1; i -= 2)
+        result *= static_cast<double>(i);
+    return result;
+}
+
+// SN3D-normalised associated Legendre value at zero elevation, without the Condon-Shortley phase.
+double horizontalLegendre(int degree, int order) noexcept
+{
+    if (((degree + order) & 1) != 0)
+        return 0.0;
+
+    const auto sign = (((degree - order) / 2) & 1) != 0 ? -1.0 : 1.0;
+    const auto legendre = sign * doubleFactorial(degree + order - 1) / doubleFactorial(degree - order);
+    const auto normalisation = std::sqrt((order == 0 ? 1.0 : 2.0) * factorial(degree - order) / factorial(degree + order));
+    return normalisation * legendre;
+}
+} // namespace
+
+void ChannelPanner::setMono() noexcept
+{
+    mode = Mode::mono;
+    numChannels = 1;
+    ringSize = 0;
+}
+
+void ChannelPanner::setSpeakers(const double* azimuthsDegrees, int channelCount) noexcept
+{
+    mode = Mode::speakers;
+    numChannels = std::min(channelCount, maxChannels);
+    ringSize = 0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        if (azimuthsDegrees[channel] >= excludedSpeaker)
+            continue;
+
+        ringOrder[static_cast<size_t>(ringSize)] = channel;
+        ringAzimuths[static_cast<size_t>(ringSize)] = azimuthsDegrees[channel];
+        ++ringSize;
+    }
+
+    // Insertion sort keeps the channel indices paired with their azimuths
+    for (int i = 1; i < ringSize; ++i)
+    {
+        for (int j = i; j > 0 && ringAzimuths[static_cast<size_t>(j - 1)] > ringAzimuths[static_cast<size_t>(j)]; --j)
+        {
+            std::swap(ringAzimuths[static_cast<size_t>(j - 1)], ringAzimuths[static_cast<size_t>(j)]);
+            std::swap(ringOrder[static_cast<size_t>(j - 1)], ringOrder[static_cast<size_t>(j)]);
+        }
+    }
+}
+
+void ChannelPanner::setAmbisonic(int order) noexcept
+{
+    mode = Mode::ambisonic;
+    ambisonicOrder = std::max(0, order);
+
+    while ((ambisonicOrder + 1) * (ambisonicOrder + 1) > maxChannels)
+        --ambisonicOrder;
+
+    numChannels = (ambisonicOrder + 1) * (ambisonicOrder + 1);
+    ringSize = 0;
+}
+
+void ChannelPanner::computeGains(double pan, double* gains) const noexcept
+{
+    const auto clipped = std::clamp(pan, -1.0, 1.0);
+
+    if (mode == Mode::mono)
+    {
+        gains[0] = 0.5;
+        return;
+    }
+
+    std::fill(gains, gains + numChannels, 0.0);
+
+    if (mode == Mode::ambisonic)
+    {
+        // AmbiX azimuth is counter-clockwise, so hard left (pan -1) sits at +90 degrees
+        const auto azimuth = -clipped * halfPi;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto degree = static_cast<int>(std::sqrt(static_cast<double>(channel)));
+            const auto order = channel - degree * (degree + 1);
+            const auto absoluteOrder = std::abs(order);
+            const auto circular = order >= 0 ? std::cos(absoluteOrder * azimuth) : std::sin(absoluteOrder * azimuth);
+            gains[channel] = horizontalLegendre(degree, absoluteOrder) * circular;
+        }
+
+        return;
+    }
+
+    if (ringSize == 0)
+        return;
+
+    if (ringSize == 1)
+    {
+        gains[ringOrder[0]] = 1.0;
+        return;
+    }
+
+    auto azimuth = clipped * 90.0;
+    auto lower = ringSize - 1;
+    auto upper = 0;
+    auto lowerAzimuth = ringAzimuths[static_cast<size_t>(lower)];
+    auto upperAzimuth = ringAzimuths[0] + 360.0;
+
+    for (int i = 0; i + 1 < ringSize; ++i)
+    {
+        if (azimuth >= ringAzimuths[static_cast<size_t>(i)] && azimuth < ringAzimuths[static_cast<size_t>(i + 1)])
+        {
+            lower = i;
+            upper = i + 1;
+            lowerAzimuth = ringAzimuths[static_cast<size_t>(i)];
+            upperAzimuth = ringAzimuths[static_cast<size_t>(i + 1)];
+            break;
+        }
+    }
+
+    // Sources behind the ring's first speaker pan across the wrap-around pair
+    if (lower == ringSize - 1 && azimuth < lowerAzimuth)
+        azimuth += 360.0;
+
+    const auto span = upperAzimuth - lowerAzimuth;
+    const auto position = span > 0.0 ? std::clamp((azimuth - lowerAzimuth) / span, 0.0, 1.0) : 0.0;
+    gains[ringOrder[static_cast<size_t>(lower)]] = std::cos(position * halfPi);
+    gains[ringOrder[static_cast<size_t>(upper)]] += std::sin(position * halfPi);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+
+// Turns a tone's pan position into one gain per output channel.
+//
+// Pan runs from -1 (hard left) to +1 (hard right), which maps to azimuths -90 to +90
+// degrees. Speaker layouts use pairwise constant-power panning between neighbouring
+// speakers on the horizontal ring; a plain stereo pair sits at +/-90 degrees, which
+// reproduces the sin/cos pan law exactly. Ambisonic layouts are encoded to ACN channel
+// order with SN3D normalisation (AmbiX) on the horizontal plane. Mono sums both tones
+// at half gain, as it always has.
+class ChannelPanner
+{
+public:
+    static constexpr int maxChannels = 16;
+
+    // Speakers with no place on the horizontal ring (LFE, height, discrete) get no signal.
+    static constexpr double excludedSpeaker = 1000.0;
+
+    void setMono() noexcept;
+    void setSpeakers(const double* azimuthsDegrees, int numChannels) noexcept;
+    void setAmbisonic(int order) noexcept;
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    void computeGains(double pan, double* gains) const noexcept;
+
+private:
+    enum class Mode
+    {
+        mono,
+        speakers,
+        ambisonic
+    };
+
+    Mode mode = Mode::mono;
+    int numChannels = 1;
+    int ambisonicOrder = 0;
+
+    // Speaker channel indices sorted by azimuth, for finding the pair either side of a source.
+    std::array<int, maxChannels> ringOrder {};
+    std::array<double, maxChannels> ringAzimuths {};
+    int ringSize = 0;
+};
@@ -0,0 +1,253 @@
+#include "DualToneC.h"
+#include "DualToneEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+static_assert(DUALTONE_NUM_PARAMETERS == PluginState::numParameters, "DualToneParameter must follow PluginState::Parameter");
+
+constexpr int maxChannels = 8;
+
+// Conversions to integer formats render this many frames at a time into the generator's own float buffer.
+constexpr int scratchFrames = 512;
+
+float constrainParameter(int parameter, float value) noexcept
+{
+    return PluginState::parameterRanges[parameter].constrain(value);
+}
+
+bool isValidParameter(int parameter) noexcept
+{
+    return parameter >= 0 && parameter < PluginState::numParameters;
+}
+
+bool isValidFormat(DualToneSampleFormat format) noexcept
+{
+    return format == DUALTONE_FLOAT32 || format == DUALTONE_INT16 || format == DUALTONE_INT24;
+}
+
+// Writes numSamples samples to destination, stride samples apart, in the given format.
+void convertSamples(const float* source, void* destination, int stride, int numSamples, DualToneSampleFormat format) noexcept
+{
+    switch (format)
+    {
+        case DUALTONE_FLOAT32:
+        {
+            auto* output = static_cast<float*>(destination);
+
+            for (int i = 0; i < numSamples; ++i)
+                output[i * stride] = source[i];
+
+            break;
+        }
+
+        case DUALTONE_INT16:
+        {
+            auto* output = static_cast<std::int16_t*>(destination);
+
+            for (int i = 0; i < numSamples; ++i)
+                output[i * stride] = static_cast<std::int16_t>(std::lrint(std::clamp(source[i], -1.0f, 1.0f) * 32767.0f));
+
+            break;
+        }
+
+        case DUALTONE_INT24:
+        {
+            auto* output = static_cast<std::uint8_t*>(destination);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto sample = static_cast<std::int32_t>(std::lrint(std::clamp(source[i], -1.0f, 1.0f) * 8388607.0f));
+                auto* bytes = output + 3 * i * stride;
+                bytes[0] = static_cast<std::uint8_t>(sample & 0xff);
+                bytes[1] = static_cast<std::uint8_t>((sample >> 8) & 0xff);
+                bytes[2] = static_cast<std::uint8_t>((sample >> 16) & 0xff);
+            }
+
+            break;
+        }
+    }
+}
+
+int getBytesPerSample(DualToneSampleFormat format) noexcept
+{
+    return format == DUALTONE_INT16 ? 2 : (format == DUALTONE_INT24 ? 3 : 4);
+}
+} // namespace
+
+struct DualToneGenerator
+{
+    DualToneGenerator(double sampleRate, int channelCount)
+        : numChannels(channelCount),
+          scratch(channelCount, scratchFrames)
+    {
+        DualToneEngine::ParameterValues pointers;
+
+        for (int parameter = 0; parameter < PluginState::numParameters; ++parameter)
+        {
+            values[static_cast<size_t>(parameter)].store(PluginState::parameterRanges[parameter].defaultValue);
+            pointers[static_cast<size_t>(parameter)] = &values[static_cast<size_t>(parameter)];
+        }
+
+        // No worker, so every table is built inline and nothing renders in the background
+        engine.setParameterValues(pointers);
+        engine.setNonRealtime(true);
+        engine.prepare(sampleRate);
+        engine.setChannelLayout(juce::AudioChannelSet::canonicalChannelSet(channelCount));
+    }
+
+    void render(juce::AudioBuffer<float>& buffer) { engine.process(buffer, noMidi); }
+
+    // Renders through the scratch buffer and writes each piece out with convert(chunk, offset, count).
+    template <typename Convert>
+    void renderConverted(int numFrames, Convert&& convert)
+    {
+        for (int offset = 0; offset < numFrames; offset += scratchFrames)
+        {
+            const auto count = std::min(scratchFrames, numFrames - offset);
+            juce::AudioBuffer<float> chunk(scratch.getArrayOfWritePointers(), numChannels, count);
+            render(chunk);
+            convert(chunk, offset, count);
+        }
+    }
+
+    std::array<std::atomic<float>, PluginState::numParameters> values;
+    DualToneEngine engine;
+    const int numChannels;
+    juce::AudioBuffer<float> scratch;
+    const juce::MidiBuffer noMidi;
+};
+
+extern "C" {
+
+DualToneGenerator* dualtone_create(double sampleRate, int numChannels)
+{
+    if (! (sampleRate > 0.0) || numChannels < 1 || numChannels > maxChannels)
+        return nullptr;
+
+    // Exceptions must not cross into C; the engine's and buffers' allocations can throw
+    try
+    {
+        return new DualToneGenerator(sampleRate, numChannels);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void dualtone_destroy(DualToneGenerator* generator)
+{
+    delete generator;
+}
+
+DualToneStatus dualtone_set_parameter(DualToneGenerator* generator, int parameter, float value)
+{
+    if (generator == nullptr || ! isValidParameter(parameter))
+        return DUALTONE_INVALID_ARGUMENT;
+
+    generator->values[static_cast<size_t>(parameter)].store(constrainParameter(parameter, value));
+    return DUALTONE_OK;
+}
+
+DualToneStatus dualtone_set_parameters(DualToneGenerator* generator, const float* values, int numValues)
+{
+    if (generator == nullptr || values == nullptr || numValues < 0 || numValues > PluginState::numParameters)
+        return DUALTONE_INVALID_ARGUMENT;
+
+    const auto batch = generator->engine.batchParameterChanges();
+
+    for (int parameter = 0; parameter < numValues; ++parameter)
+        generator->values[static_cast<size_t>(parameter)].store(constrainParameter(parameter, values[parameter]));
+
+    return DUALTONE_OK;
+}
+
+float dualtone_get_parameter(const DualToneGenerator* generator, int parameter)
+{
+    if (generator == nullptr || ! isValidParameter(parameter))
+        return 0.0f;
+
+    return generator->values[static_cast<size_t>(parameter)].load();
+}
+
+int dualtone_get_latency(const DualToneGenerator* generator)
+{
+    return generator != nullptr ? generator->engine.getLatencyInSamples() : 0;
+}
+
+DualToneStatus dualtone_seek(DualToneGenerator* generator, int64_t samplePosition)
+{
+    if (generator == nullptr || samplePosition < 0)
+        return DUALTONE_INVALID_ARGUMENT;
+
+    generator->engine.seekTo(samplePosition);
+    return DUALTONE_OK;
+}
+
+DualToneStatus dualtone_render_planar(DualToneGenerator* generator,
+                                      void* const* channels,
+                                      int numFrames,
+                                      DualToneSampleFormat format)
+{
+    if (generator == nullptr || channels == nullptr || numFrames < 0 || ! isValidFormat(format))
+        return DUALTONE_INVALID_ARGUMENT;
+
+    for (int channel = 0; channel < generator->numChannels; ++channel)
+        if (channels[channel] == nullptr)
+            return DUALTONE_INVALID_ARGUMENT;
+
+    if (numFrames == 0)
+        return DUALTONE_OK;
+
+    if (format == DUALTONE_FLOAT32)
+    {
+        // The engine writes straight into the caller's channels
+        juce::AudioBuffer<float> buffer(reinterpret_cast<float* const*>(channels), generator->numChannels, numFrames);
+        generator->render(buffer);
+        return DUALTONE_OK;
+    }
+
+    const auto bytesPerSample = getBytesPerSample(format);
+
+    generator->renderConverted(numFrames, [&](const juce::AudioBuffer<float>& chunk, int offset, int count)
+    {
+        for (int channel = 0; channel < chunk.getNumChannels(); ++channel)
+        {
+            auto* destination = static_cast<char*>(channels[channel]) + offset * bytesPerSample;
+            convertSamples(chunk.getReadPointer(channel), destination, 1, count, format);
+        }
+    });
+
+    return DUALTONE_OK;
+}
+
+DualToneStatus dualtone_render_interleaved(DualToneGenerator* generator,
+                                           void* frames,
+                                           int numFrames,
+                                           DualToneSampleFormat format)
+{
+    if (generator == nullptr || frames == nullptr || numFrames < 0 || ! isValidFormat(format))
+        return DUALTONE_INVALID_ARGUMENT;
+
+    if (numFrames == 0)
+        return DUALTONE_OK;
+
+    const auto bytesPerSample = getBytesPerSample(format);
+    const auto numChannels = generator->numChannels;
+
+    generator->renderConverted(numFrames, [&](const juce::AudioBuffer<float>& chunk, int offset, int count)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* destination = static_cast<char*>(frames) + (offset * numChannels + channel) * bytesPerSample;
+            convertSamples(chunk.getReadPointer(channel), destination, numChannels, count, format);
+        }
+    });
+
+    return DUALTONE_OK;
+}
+
+} // extern "C"
@@ -0,0 +1,103 @@
+#pragma once
+
+/* C interface to the tone engine, for hosts that are not JUCE plugins.
+ *
+ * A generator renders the same signal as the plugin's processBlock, from parameters set through
+ * this interface instead of a host. The caller owns every buffer, and float planar renders are
+ * written straight into them. dualtone_create() allocates everything the generator needs. After
+ * that, no call allocates, locks or starts a thread; shaper tables are built inline on the
+ * rendering thread when a setting first needs them.
+ *
+ * A generator is not thread-safe: calls on one generator must not overlap. Separate generators
+ * are independent. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Everything else is built with hidden visibility, so these are all the DualToneC shared library exports. */
+#if defined(__GNUC__)
+ #define DUALTONE_API __attribute__((visibility("default")))
+#else
+ #define DUALTONE_API
+#endif
+
+typedef struct DualToneGenerator DualToneGenerator;
+
+typedef enum DualToneStatus
+{
+    DUALTONE_OK = 0,
+    DUALTONE_INVALID_ARGUMENT = -1
+} DualToneStatus;
+
+/* Parameter indices, in the order of the plugin's saved state. Ranges and defaults are the
+ * plugin's own, from PluginState::parameterRanges. */
+typedef enum DualToneParameter
+{
+    DUALTONE_CENTER_FREQ,   /* Hz */
+    DUALTONE_SPREAD,        /* Hz */
+    DUALTONE_PAN_1,         /* -1 (left) to 1 (right) */
+    DUALTONE_PAN_2,
+    DUALTONE_ATTEN_1,       /* dB */
+    DUALTONE_ATTEN_2,
+    DUALTONE_GAIN,          /* dB */
+    DUALTONE_DRIVE,         /* dB */
+    DUALTONE_SHAPE_TYPE,    /* 0 (tanh) to 1 (atan) */
+    DUALTONE_SHAPE_MODE,    /* 0 direct, 1 harmonic */
+    DUALTONE_OVERSAMPLING,  /* 0 off, 1 2x, 2 4x, 3 8x */
+    DUALTONE_VOICE_MODE,    /* 0 drone, 1 MIDI; no notes reach the generator, so MIDI mode is silent */
+    DUALTONE_MORPH,         /* 0 to 1; no effect, as the interface sets no morph path */
+    DUALTONE_NUM_PARAMETERS
+} DualToneParameter;
+
+typedef enum DualToneSampleFormat
+{
+    DUALTONE_FLOAT32,   /* native float, full scale at +-1 */
+    DUALTONE_INT16,     /* native-endian signed 16 bit */
+    DUALTONE_INT24      /* packed 3-byte little-endian signed 24 bit */
+} DualToneSampleFormat;
+
+/* Returns NULL if the sample rate is not positive, numChannels is outside 1 to 8, or memory runs
+ * out. The channels are laid out as mono, stereo, LCR, quad, 5.0, 5.1, 7.0 or 7.1, and the tones
+ * are panned across them as in the plugin. Every parameter starts at its default. */
+DUALTONE_API DualToneGenerator* dualtone_create(double sampleRate, int numChannels);
+
+/* Accepts NULL. */
+DUALTONE_API void dualtone_destroy(DualToneGenerator* generator);
+
+/* Sets one parameter in its own units. Values outside the parameter's range are clamped, and
+ * choices are rounded. Takes effect at the next render, ramping like a host automation move. */
+DUALTONE_API DualToneStatus dualtone_set_parameter(DualToneGenerator* generator, int parameter, float value);
+
+/* Sets the first numValues parameters from values, in DualToneParameter order. They reach the
+ * next render together. */
+DUALTONE_API DualToneStatus dualtone_set_parameters(DualToneGenerator* generator, const float* values, int numValues);
+
+/* Returns the parameter's current value, or 0 for an invalid index. */
+DUALTONE_API float dualtone_get_parameter(const DualToneGenerator* generator, int parameter);
+
+/* Latency of the current oversampling setting, in samples. */
+DUALTONE_API int dualtone_get_latency(const DualToneGenerator* generator);
+
+/* Starts the next render at the tone phases reached samplePosition samples after phase zero, at
+ * the current parameter values. Constant time for any position. */
+DUALTONE_API DualToneStatus dualtone_seek(DualToneGenerator* generator, int64_t samplePosition);
+
+/* Renders numFrames frames into channels[0] to channels[numChannels - 1], one buffer per
+ * channel, replacing their contents. */
+DUALTONE_API DualToneStatus dualtone_render_planar(DualToneGenerator* generator,
+                                                   void* const* channels,
+                                                   int numFrames,
+                                                   DualToneSampleFormat format);
+
+/* Renders numFrames frames into one buffer, the channels of each frame next to each other. */
+DUALTONE_API DualToneStatus dualtone_render_interleaved(DualToneGenerator* generator,
+                                                        void* frames,
+                                                        int numFrames,
+                                                        DualToneSampleFormat format);
+
+#ifdef __cplusplus
+}
+#endif
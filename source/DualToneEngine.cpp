@@ -0,0 +1,910 @@
+#include "DualToneEngine.h"
+#include "PrecisionPolicy.h"
+#include "ToneKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace
+{
+// Oscillators render into stack scratch in chunks of this size, so any host block size works without allocating.
+constexpr int renderChunkSize = 256;
+
+// Time a parameter change takes to reach its new value. Ramps advance a whole render chunk at a
+// time and are interpolated per sample inside the chunk, so they stay linear end to end.
+constexpr double parameterRampSeconds = 0.05;
+
+// Horizontal azimuth of each speaker in degrees, negative to the left; see ChannelPanner.
+double getSpeakerAzimuth(juce::AudioChannelSet::ChannelType type, const juce::AudioChannelSet& layout)
+{
+    using Set = juce::AudioChannelSet;
+
+    // A plain stereo pair spans the full pan range, which keeps the original sin/cos pan law
+    const auto stereo = layout == Set::stereo();
+    const auto quad = layout == Set::quadraphonic();
+
+    switch (type)
+    {
+        case Set::left:              return stereo ? -90.0 : (quad ? -45.0 : -30.0);
+        case Set::right:             return stereo ? 90.0 : (quad ? 45.0 : 30.0);
+        case Set::centre:            return 0.0;
+        case Set::leftCentre:        return -15.0;
+        case Set::rightCentre:       return 15.0;
+        case Set::wideLeft:          return -60.0;
+        case Set::wideRight:         return 60.0;
+        case Set::leftSurroundSide:  return -90.0;
+        case Set::rightSurroundSide: return 90.0;
+        case Set::leftSurround:      return quad ? -135.0 : -110.0;
+        case Set::rightSurround:     return quad ? 135.0 : 110.0;
+        case Set::leftSurroundRear:  return -150.0;
+        case Set::rightSurroundRear: return 150.0;
+        case Set::centreSurround:    return 180.0;
+        default:                     return ChannelPanner::excludedSpeaker;
+    }
+}
+
+void configurePanner(ChannelPanner& panner, const juce::AudioChannelSet& layout)
+{
+    if (layout.size() <= 1)
+    {
+        panner.setMono();
+        return;
+    }
+
+    if (const auto order = layout.getAmbisonicOrder(); order > 0)
+    {
+        panner.setAmbisonic(order);
+        return;
+    }
+
+    double azimuths[ChannelPanner::maxChannels];
+    const auto numChannels = juce::jmin(layout.size(), ChannelPanner::maxChannels);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        azimuths[channel] = getSpeakerAzimuth(layout.getTypeOfChannel(channel), layout);
+
+    panner.setSpeakers(azimuths, numChannels);
+}
+} // namespace
+
+void DualToneEngine::setParameterValues(const ParameterValues& values) noexcept
+{
+    parameterValues = values;
+
+    ParameterSnapshot::Sources sources;
+    std::copy(values.begin(), values.end(), sources.begin());
+    parameterSnapshot.setSources(sources);
+}
+
+void DualToneEngine::attachWorker(juce::TimeSliceThread& worker)
+{
+    worker.addTimeSliceClient(&shaperTables);
+    worker.addTimeSliceClient(&renderCache);
+}
+
+void DualToneEngine::detachWorker(juce::TimeSliceThread& worker)
+{
+    worker.removeTimeSliceClient(&renderCache);
+    worker.removeTimeSliceClient(&shaperTables);
+}
+
+void DualToneEngine::runBackgroundWork()
+{
+    shaperTables.useTimeSlice();
+    renderCache.useTimeSlice();
+}
+
+void DualToneEngine::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+
+    // Start from the current parameter values rather than ramping in from stale ones
+    parameterSnapshot.update();
+    setRampTargets();
+    for (auto& ramp : parameterRamps)
+        ramp.reset(sampleRate, parameterRampSeconds);
+
+    targetSettingsNeedUpdate = true;
+
+    voices.prepare(sampleRate);
+    voices.reset();
+
+    // Layout changes glide like parameter changes, except for the first layout after preparing
+    toneBank.setRampLength(static_cast<int>(std::floor(parameterRampSeconds * sampleRate)));
+    toneBank.finishRamp();
+    toneBankJumpsToLayout = true;
+
+    shaperOversampler.prepare(renderChunkSize);
+    shaperStageNeedsPriming = true;
+    renderCache.invalidate();
+}
+
+void DualToneEngine::setChannelLayout(const juce::AudioChannelSet& layout)
+{
+    configurePanner(panner, layout);
+
+    panGainsNeedUpdate = true;
+    toneBankGainsNeedUpdate = true;
+    morphStatePanGainsNeedUpdate = true;
+}
+
+int DualToneEngine::getLatencyInSamples() const noexcept
+{
+    const auto stage = juce::jlimit(0,
+                                    ShaperOversampler::numStages - 1,
+                                    juce::roundToInt(parameterValues[PluginState::oversampling]->load()));
+    // The tone bank mixes straight to the outputs without the shaper stage, so it adds no latency
+    return isToneBankActive() ? 0 : shaperOversampler.getLatencyInSamples(stage);
+}
+
+bool DualToneEngine::isToneBankActive() const noexcept
+{
+    return toneBankEnabled.load() && parameterValues[PluginState::voiceMode]->load() < 0.5f;
+}
+
+void DualToneEngine::setRampTargets()
+{
+    auto setTarget = [this](SmoothedParameter index, PluginState::Parameter parameter)
+    {
+        parameterRamps[index].setTarget(static_cast<double>(parameterSnapshot[parameter]));
+    };
+
+    setTarget(smoothedCenterFrequency, PluginState::centerFreq);
+    setTarget(smoothedSpread, PluginState::spread);
+    setTarget(smoothedPanOne, PluginState::pan1);
+    setTarget(smoothedPanTwo, PluginState::pan2);
+    setTarget(smoothedAttenuationOne, PluginState::atten1);
+    setTarget(smoothedAttenuationTwo, PluginState::atten2);
+    setTarget(smoothedGain, PluginState::gain);
+    setTarget(smoothedDrive, PluginState::drive);
+    setTarget(smoothedShapeType, PluginState::shapeType);
+    setTarget(smoothedMorph, PluginState::morph);
+}
+
+int DualToneEngine::getSamplesToNextRampEnd(int maxSamples) const
+{
+    auto samples = maxSamples;
+
+    for (const auto& ramp : parameterRamps)
+        if (ramp.isRamping())
+            samples = juce::jmin(samples, ramp.getRemainingSamples());
+
+    return samples;
+}
+
+DualToneEngine::ToneSettings DualToneEngine::getToneSettings(bool atTarget) const
+{
+    auto value = [this, atTarget](SmoothedParameter index)
+    {
+        return atTarget ? parameterRamps[index].getTarget() : parameterRamps[index].getCurrent();
+    };
+
+    ToneSettings settings;
+    settings.morphPosition = value(smoothedMorph);
+
+    if (activeMorph != nullptr)
+    {
+        // The states carry their linear gains already, so a morph only interpolates
+        const auto segment = activeMorph->locate(settings.morphPosition);
+        const auto& from = activeMorph->states[static_cast<size_t>(segment.index)];
+        const auto& to = activeMorph->states[static_cast<size_t>(segment.index) + 1];
+        const auto interpolate = [&segment](double start, double end) { return start + (end - start) * segment.weight; };
+
+        settings.centerFrequency = interpolate(from.centerFrequency, to.centerFrequency);
+        settings.spread = interpolate(from.spread, to.spread);
+        settings.toneGain = interpolate(from.toneGain, to.toneGain);
+        settings.gainOne = interpolate(from.gainOne, to.gainOne);
+        settings.gainTwo = interpolate(from.gainTwo, to.gainTwo);
+        settings.panOne = interpolate(from.panOne, to.panOne);
+        settings.panTwo = interpolate(from.panTwo, to.panTwo);
+        settings.driveDb = interpolate(from.driveDb, to.driveDb);
+        settings.typeMix = interpolate(from.typeMix, to.typeMix);
+    }
+    else
+    {
+        settings.centerFrequency = value(smoothedCenterFrequency);
+        settings.spread = value(smoothedSpread);
+        settings.toneGain = juce::Decibels::decibelsToGain(baseToneGainDb + value(smoothedGain));
+        settings.gainOne = settings.toneGain * juce::Decibels::decibelsToGain(value(smoothedAttenuationOne));
+        settings.gainTwo = settings.toneGain * juce::Decibels::decibelsToGain(value(smoothedAttenuationTwo));
+        settings.panOne = value(smoothedPanOne);
+        settings.panTwo = value(smoothedPanTwo);
+        settings.driveDb = value(smoothedDrive);
+        settings.typeMix = juce::jlimit(0.0, 1.0, value(smoothedShapeType));
+    }
+
+    settings.frequencyOne = juce::jmax(0.0, settings.centerFrequency - settings.spread);
+    settings.frequencyTwo = juce::jmax(0.0, settings.centerFrequency + settings.spread);
+    settings.incrementOne = (juce::MathConstants<double>::twoPi * settings.frequencyOne) / currentSampleRate;
+    settings.incrementTwo = (juce::MathConstants<double>::twoPi * settings.frequencyTwo) / currentSampleRate;
+    return settings;
+}
+
+int DualToneEngine::getSamplesToNextMorphState(int maxSamples) const
+{
+    const auto& ramp = parameterRamps[smoothedMorph];
+
+    if (activeMorph == nullptr || ! ramp.isRamping())
+        return maxSamples;
+
+    const auto start = ramp.getCurrent();
+    const auto step = (ramp.getTarget() - start) / static_cast<double>(ramp.getRemainingSamples());
+
+    if (step == 0.0)
+        return maxSamples;
+
+    const auto samples = std::ceil((activeMorph->getNextStatePosition(start, ramp.getTarget()) - start) / step);
+    return static_cast<int>(juce::jlimit(1.0, static_cast<double>(maxSamples), samples));
+}
+
+void DualToneEngine::updateMorphStatePanGains() noexcept
+{
+    for (size_t state = 0; state < activeMorph->states.size(); ++state)
+    {
+        panner.computeGains(activeMorph->states[state].panOne, morphStatePanGainsOne[state]);
+        panner.computeGains(activeMorph->states[state].panTwo, morphStatePanGainsTwo[state]);
+    }
+
+    morphStatePanGainsNeedUpdate = false;
+}
+
+void DualToneEngine::getMorphPanGains(double position, double* gainsOne, double* gainsTwo) const noexcept
+{
+    const auto segment = activeMorph->locate(position);
+    const auto* fromOne = morphStatePanGainsOne[segment.index];
+    const auto* toOne = morphStatePanGainsOne[segment.index + 1];
+    const auto* fromTwo = morphStatePanGainsTwo[segment.index];
+    const auto* toTwo = morphStatePanGainsTwo[segment.index + 1];
+
+    for (int channel = 0; channel < panner.getNumChannels(); ++channel)
+    {
+        gainsOne[channel] = fromOne[channel] + (toOne[channel] - fromOne[channel]) * segment.weight;
+        gainsTwo[channel] = fromTwo[channel] + (toTwo[channel] - fromTwo[channel]) * segment.weight;
+    }
+}
+
+template <typename SampleType>
+void DualToneEngine::process(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages)
+{
+    // Tone buffers use the policy's kernel type; see PrecisionPolicy for which stages stay in double
+    using Kernel = typename PrecisionPolicy<SampleType>::Kernel;
+
+    juce::ScopedNoDenormals disableDenormals;
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
+
+    playingFromCache = false;
+
+    if (numSamples == 0 || numChannels == 0)
+        return;
+
+    applyPendingPreset();
+
+    // One coherent set of values for the whole block; a batch still being written waits for the next one
+    if (parameterSnapshot.update())
+        targetSettingsNeedUpdate = true;
+
+    const auto harmonicShaping = parameterSnapshot[PluginState::shapeMode] >= 0.5f;
+    const auto midiVoices = parameterSnapshot[PluginState::voiceMode] >= 0.5f;
+
+    if (midiVoices != midiVoiceMode)
+    {
+        midiVoiceMode = midiVoices;
+        voices.reset();
+        shaperStageNeedsPriming = true;
+    }
+
+    // The path stays pinned until the block is done; every read of activeMorph happens before that
+    activeMorph = morphSlots.pin();
+
+    if (activeMorph != nullptr && ! activeMorph->isActive())
+        activeMorph = nullptr;
+
+    if (activeMorph != nullptr && activeMorph->revision != appliedMorphRevision)
+    {
+        appliedMorphRevision = activeMorph->revision;
+        morphStatePanGainsNeedUpdate = true;
+        panGainsNeedUpdate = true;
+        targetSettingsNeedUpdate = true;
+    }
+
+    if ((activeMorph != nullptr) != morphWasActive)
+    {
+        morphWasActive = activeMorph != nullptr;
+        targetSettingsNeedUpdate = true;
+    }
+
+    // Layouts are installed once the morph is pinned, as a glide from the pair needs its current settings
+    if (auto* layout = toneBankSlots.pin())
+    {
+        if (layout->revision != appliedToneBankRevision)
+        {
+            installToneBankLayout(*layout, midiVoices);
+            appliedToneBankRevision = layout->revision;
+        }
+    }
+
+    toneBankSlots.unpin();
+
+    if (pendingPresetToneBank != nullptr)
+    {
+        installToneBankLayout(*pendingPresetToneBank, midiVoices);
+        pendingPresetToneBank = nullptr;
+    }
+
+    toneBankJumpsToLayout = false;
+    finishToneBankHandover();
+
+    const auto toneBankActive = ! midiVoices && toneBank.getNumPartials() > 0;
+
+    if (toneBankActive && toneBankGainsNeedUpdate)
+    {
+        toneBank.updateChannelGains(panner);
+        toneBankGainsNeedUpdate = false;
+    }
+
+    // The ramp targets, and the gains and increments derived from them, only move with the snapshot
+    if (targetSettingsNeedUpdate)
+    {
+        setRampTargets();
+        targetSettings = getToneSettings(true);
+        targetSettingsNeedUpdate = false;
+    }
+
+    // With no parameter ramping every chunk sees the same settings and the loop below runs only the
+    // block-constant kernels. Ramping parameters are stepped once per chunk and interpolated per
+    // sample inside it, and only the stages they feed switch to their per-sample paths.
+    const auto ramping = std::any_of(std::begin(parameterRamps),
+                                     std::end(parameterRamps),
+                                     [](const ParameterRamp& ramp) { return ramp.isRamping(); });
+    const auto& target = targetSettings;
+
+    // A ramp that has finished sits exactly on its target, so a still block starts from the target settings
+    auto current = ramping ? getToneSettings(false) : target;
+
+    // Pan gains only change with the pan controls or the channel layout. A morph interpolates
+    // between the gains of its states instead, which only change with the path or the layout.
+    if (activeMorph != nullptr)
+    {
+        if (morphStatePanGainsNeedUpdate)
+            updateMorphStatePanGains();
+
+        getMorphPanGains(current.morphPosition, panGainsOne, panGainsTwo);
+
+        // Recompute from the pan controls once the morph ends
+        panGainsNeedUpdate = true;
+    }
+    else if (panGainsNeedUpdate || current.panOne != lastPanOne || current.panTwo != lastPanTwo)
+    {
+        panner.computeGains(current.panOne, panGainsOne);
+        panner.computeGains(current.panTwo, panGainsTwo);
+        lastPanOne = current.panOne;
+        lastPanTwo = current.panTwo;
+        panGainsNeedUpdate = false;
+    }
+
+    const auto numPannedChannels = juce::jmin(numChannels, panner.getNumChannels());
+
+    oscillatorOne.setPhaseIncrement(current.incrementOne);
+    oscillatorTwo.setPhaseIncrement(current.incrementTwo);
+
+    if (pendingSeekPosition >= 0)
+    {
+        const auto position = static_cast<std::uint64_t>(pendingSeekPosition);
+        oscillatorOne.seek(0, position);
+        oscillatorTwo.seek(0, position);
+        toneBank.setCenterFrequency(current.centerFrequency, currentSampleRate);
+        toneBank.seek(pendingSeekPosition);
+        voices.reset();
+        shaperStageNeedsPriming = true;
+        renderCache.invalidate();
+        pendingSeekPosition = -1;
+    }
+
+    // A morph shapes with the tables of the states around its position, crossfading between them
+    auto morphShaping = activeMorph != nullptr ? activeMorph->getShaping(current.morphPosition, current.morphPosition)
+                                               : MorphPath::Shaping {};
+
+    // Use the prebuilt transfer table when it matches; otherwise evaluate the exact curve until the worker catches up
+    const auto targetDriveDb = static_cast<float>(target.driveDb);
+    const auto targetTypeMix = static_cast<float>(target.typeMix);
+    auto* shaperTable = activeMorph != nullptr ? morphShaping.from : shaperTables.acquire(targetDriveDb, targetTypeMix);
+
+    // Offline output must not depend on how quickly the worker builds tables
+    if (shaperTable == nullptr && nonRealtime)
+    {
+        if (! offlineShaperTable.matches(targetDriveDb, targetTypeMix))
+            offlineShaperTable.build(WaveshaperCurve::fromParameters(targetDriveDb, targetTypeMix));
+
+        shaperTable = &offlineShaperTable;
+    }
+
+    const auto exactCurve = shaperTable == nullptr ? WaveshaperCurve::fromParameters(targetDriveDb, targetTypeMix)
+                                                   : WaveshaperCurve {};
+    const auto shapeExactDouble = ToneKernels::selectExactShaper<double>(exactCurve);
+    const auto shapeExactKernel = ToneKernels::selectExactShaper<Kernel>(exactCurve);
+
+    // Harmonic mode resynthesises each tone from the curve's Fourier series, keeping only harmonics below
+    // Nyquist. During a morph the table changes between chunks, so every state's series bounds the count.
+    auto getNumHarmonicsBelow = [&](double frequency)
+    {
+        if (! harmonicShaping || shaperTable == nullptr)
+            return 0;
+
+        return activeMorph != nullptr ? activeMorph->getNumHarmonicsBelow(frequency, currentSampleRate)
+                                      : shaperTable->getHarmonics().getNumHarmonicsBelow(frequency, currentSampleRate);
+    };
+
+    // A frequency ramp moves monotonically towards its target, so the higher end bounds the block
+    const auto harmonicsOne = getNumHarmonicsBelow(juce::jmax(current.frequencyOne, target.frequencyOne));
+    const auto harmonicsTwo = getNumHarmonicsBelow(juce::jmax(current.frequencyTwo, target.frequencyTwo));
+
+    // While drive or type ramps there is no table for the intermediate curves, so each chunk crossfades
+    // the exact curves at its two ends instead
+    auto shapeRamping = false;
+    WaveshaperCurve rampStartCurve;
+    WaveshaperCurve rampEndCurve;
+
+    // The shapers take kernel-typed tones at the base rate and double inside the oversampler and the pools
+    auto shapeOversampled = [&](auto* data, int count)
+    {
+        if (morphShaping.to != nullptr)
+            ToneKernels::shapeTableCrossfade(*morphShaping.from, *morphShaping.to, morphShaping.weightStart, morphShaping.weightEnd, data, count);
+        else if (shapeRamping)
+            ToneKernels::shapeExactCrossfade(rampStartCurve, rampEndCurve, data, count);
+        else if (shaperTable != nullptr)
+            shaperTable->process(data, data, count);
+        else if constexpr (std::is_same_v<decltype(data), double*>)
+            shapeExactDouble(exactCurve, data, count);
+        else
+            shapeExactKernel(exactCurve, data, count);
+    };
+
+    auto shapeBaseRate = [&](auto* data, int count, int numHarmonics)
+    {
+        if (harmonicShaping && morphShaping.to != nullptr)
+            ToneKernels::renderHarmonicsCrossfade(morphShaping.from->getHarmonics(),
+                                                  morphShaping.to->getHarmonics(),
+                                                  numHarmonics,
+                                                  morphShaping.weightStart,
+                                                  morphShaping.weightEnd,
+                                                  data,
+                                                  count);
+        else if (harmonicShaping && shaperTable != nullptr && ! shapeRamping)
+            shaperTable->getHarmonics().render(data, data, count, numHarmonics);
+        else
+            shapeOversampled(data, count);
+    };
+
+    // Voices and bank partials are shaped together, so they share one harmonic limit set by the highest tone
+    auto shapeTonesBelow = [&](double* data, int count, double highestFrequency)
+    {
+        shapeBaseRate(data, count, getNumHarmonicsBelow(highestFrequency));
+    };
+
+    auto shapeVoices = [&](double* data, int count) { shapeTonesBelow(data, count, voices.getHighestFrequency()); };
+    auto shapePartials = [&](double* data, int count) { shapeTonesBelow(data, count, toneBank.getHighestFrequency()); };
+
+    // Oversampling only pays off when a significant harmonic of the shaped tones lands above Nyquist;
+    // otherwise the stage bypasses itself and just delays the tones by its latency
+    const auto oversamplingStage = juce::jlimit(0,
+                                                ShaperOversampler::numStages - 1,
+                                                juce::roundToInt(parameterSnapshot[PluginState::oversampling]));
+    const auto highestFrequency = juce::jmax(current.frequencyOne, current.frequencyTwo, target.frequencyOne, target.frequencyTwo);
+    const auto shaperAliases = shaperTable == nullptr
+                               || shaperTable->getHarmonics().getNumHarmonicsBelow(highestFrequency, currentSampleRate)
+                                      < shaperTable->getHarmonics().getNumSignificantHarmonics();
+    const auto oversample = oversamplingStage > 0 && ! harmonicShaping && ! midiVoices && ! toneBankActive && shaperAliases;
+
+    if (shaperStageNeedsPriming || oversamplingStage != activeOversamplingStage || oversample != oversamplingEngaged)
+    {
+        activeOversamplingStage = oversamplingStage;
+        oversamplingEngaged = oversample;
+        shaperStageNeedsPriming = false;
+        primeShaperStage(shapeBaseRate, shapeOversampled, harmonicsOne, harmonicsTwo);
+    }
+
+    // With zero spread and matching phases both tones are the same signal, so only tone one is rendered and shaped
+    const auto identicalTones = ! ramping
+                                && ! midiVoices
+                                && ! toneBankActive
+                                && activeOversamplingStage == 0
+                                && current.incrementOne == current.incrementTwo
+                                && oscillatorOne.getFixedPhase() == oscillatorTwo.getFixedPhase();
+    auto* const* outputs = buffer.getArrayOfWritePointers();
+
+    // A still drone is periodic. Once the worker has rendered both tones' periods, the block is mixed from
+    // them and the oscillators jump to the phases playback ends on, ready for live synthesis to take over.
+    // The cache renders from a single curve, so it cannot play a morph that sits between two states
+    const auto cacheable = ! nonRealtime && ! ramping && ! midiVoices && ! toneBankActive && activeOversamplingStage == 0 && shaperTable != nullptr
+                           && morphShaping.to == nullptr;
+
+    if (cacheable)
+    {
+        PeriodicRenderSettings settings;
+        settings.sampleRate = currentSampleRate;
+        settings.incrementOne = current.incrementOne;
+        settings.incrementTwo = current.incrementTwo;
+        settings.driveDb = targetDriveDb;
+        settings.shapeType = targetTypeMix;
+        settings.harmonicShaping = harmonicShaping;
+        settings.harmonicsOne = harmonicsOne;
+        settings.harmonicsTwo = harmonicsTwo;
+        settings.numChannels = numPannedChannels;
+
+        for (int channel = 0; channel < numPannedChannels; ++channel)
+        {
+            settings.gainsOne[channel] = current.gainOne * panGainsOne[channel];
+            settings.gainsTwo[channel] = current.gainTwo * panGainsTwo[channel];
+        }
+
+        renderCache.submit(settings, oscillatorOne.getFixedPhase(), oscillatorTwo.getFixedPhase(), sampleClock);
+
+        if (const auto* period = renderCache.acquire())
+        {
+            period->play(outputs, numPannedChannels, sampleClock, numSamples);
+            sampleClock += static_cast<std::uint64_t>(numSamples);
+
+            oscillatorOne.setFixedPhase(period->getPhaseOne(sampleClock));
+            oscillatorTwo.setFixedPhase(period->getPhaseTwo(sampleClock));
+
+            for (int channel = numPannedChannels; channel < numChannels; ++channel)
+                buffer.clear(channel, 0, numSamples);
+
+            renderCache.release();
+            shaperTables.release();
+            morphSlots.unpin();
+            activeMorph = nullptr;
+            playingFromCache = true;
+            return;
+        }
+    }
+    else
+    {
+        renderCache.invalidate();
+    }
+
+    const auto mixTones = ToneKernels::selectChannelMixer<SampleType, Kernel>(identicalTones);
+
+    Kernel waveOne[renderChunkSize];
+    Kernel waveTwo[renderChunkSize];
+    double nextPanGainsOne[ChannelPanner::maxChannels];
+    double nextPanGainsTwo[ChannelPanner::maxChannels];
+    SampleType* chunkOutputs[ChannelPanner::maxChannels];
+
+    auto midiEvent = midiMessages.cbegin();
+
+    for (int chunkStart = 0; chunkStart < numSamples;)
+    {
+        auto maxChunkSize = juce::jmin(renderChunkSize, numSamples - chunkStart);
+
+        // Note events split the chunk, so every voice starts and stops on its exact sample
+        if (midiVoices)
+        {
+            for (; midiEvent != midiMessages.cend() && (*midiEvent).samplePosition <= chunkStart; ++midiEvent)
+                handleMidiMessage((*midiEvent).getMessage());
+
+            if (midiEvent != midiMessages.cend())
+                maxChunkSize = juce::jmin(maxChunkSize, (*midiEvent).samplePosition - chunkStart);
+        }
+
+        // A chunk never runs past the end of a ramp, so ramps finish on the same sample whatever the host block size
+        const auto chunkSize = getSamplesToNextMorphState(getSamplesToNextRampEnd(maxChunkSize));
+        auto next = current;
+        const auto* endPanGainsOne = panGainsOne;
+        const auto* endPanGainsTwo = panGainsTwo;
+
+        if (ramping)
+        {
+            for (auto& ramp : parameterRamps)
+                ramp.advance(chunkSize);
+
+            next = getToneSettings(false);
+
+            if (activeMorph != nullptr)
+            {
+                morphShaping = activeMorph->getShaping(current.morphPosition, next.morphPosition);
+                shaperTable = morphShaping.from;
+
+                if (next.morphPosition != current.morphPosition)
+                {
+                    getMorphPanGains(next.morphPosition, nextPanGainsOne, nextPanGainsTwo);
+                    endPanGainsOne = nextPanGainsOne;
+                    endPanGainsTwo = nextPanGainsTwo;
+                }
+            }
+            else
+            {
+                if (next.panOne != current.panOne)
+                {
+                    panner.computeGains(next.panOne, nextPanGainsOne);
+                    endPanGainsOne = nextPanGainsOne;
+                }
+
+                if (next.panTwo != current.panTwo)
+                {
+                    panner.computeGains(next.panTwo, nextPanGainsTwo);
+                    endPanGainsTwo = nextPanGainsTwo;
+                }
+
+                shapeRamping = next.driveDb != current.driveDb || next.typeMix != current.typeMix;
+
+                if (shapeRamping)
+                {
+                    rampStartCurve = WaveshaperCurve::fromParameters(static_cast<float>(current.driveDb),
+                                                                     static_cast<float>(current.typeMix));
+                    rampEndCurve = WaveshaperCurve::fromParameters(static_cast<float>(next.driveDb),
+                                                                   static_cast<float>(next.typeMix));
+                }
+            }
+        }
+
+        if (toneBankActive)
+        {
+            // The bank applies its own levels and pans and mixes straight into the output channels
+            for (int channel = 0; channel < numPannedChannels; ++channel)
+                chunkOutputs[channel] = outputs[channel] + chunkStart;
+
+            toneBank.setCenterFrequency(current.centerFrequency, currentSampleRate);
+            toneBank.render(chunkOutputs, numPannedChannels, chunkSize, current.toneGain, next.toneGain, shapePartials);
+        }
+        else
+        {
+            if (midiVoices)
+            {
+                voices.setSpread(next.spread);
+                voices.render(waveOne, waveTwo, chunkSize, shapeVoices);
+                shaperOversampler.processBypassed(activeOversamplingStage, waveOne, waveTwo, chunkSize);
+            }
+            else
+            {
+                if (next.incrementOne == current.incrementOne)
+                    oscillatorOne.render(waveOne, chunkSize);
+                else
+                    oscillatorOne.renderRamp(waveOne, chunkSize, next.incrementOne);
+
+                if (! identicalTones)
+                {
+                    if (next.incrementTwo == current.incrementTwo)
+                        oscillatorTwo.render(waveTwo, chunkSize);
+                    else
+                        oscillatorTwo.renderRamp(waveTwo, chunkSize, next.incrementTwo);
+                }
+
+                if (oversamplingEngaged)
+                {
+                    shaperOversampler.processOversampled(activeOversamplingStage, waveOne, waveTwo, chunkSize, shapeOversampled);
+                }
+                else
+                {
+                    shapeBaseRate(waveOne, chunkSize, harmonicsOne);
+
+                    if (! identicalTones)
+                        shapeBaseRate(waveTwo, chunkSize, harmonicsTwo);
+
+                    shaperOversampler.processBypassed(activeOversamplingStage, waveOne, waveTwo, chunkSize);
+                }
+            }
+
+            // Every channel is written in full here, so the buffer is never cleared first
+            for (int channel = 0; channel < numPannedChannels; ++channel)
+            {
+                const auto startGainOne = current.gainOne * panGainsOne[channel];
+                const auto startGainTwo = current.gainTwo * panGainsTwo[channel];
+                const auto endGainOne = next.gainOne * endPanGainsOne[channel];
+                const auto endGainTwo = next.gainTwo * endPanGainsTwo[channel];
+                auto* output = outputs[channel] + chunkStart;
+
+                if (startGainOne != endGainOne || startGainTwo != endGainTwo)
+                    ToneKernels::mixTonesToChannelRamp(waveOne, waveTwo, startGainOne, endGainOne, startGainTwo, endGainTwo, output, chunkSize);
+                else if (startGainOne == 0.0 && startGainTwo == 0.0)
+                    juce::FloatVectorOperations::clear(output, chunkSize);
+                else
+                    mixTones(waveOne, waveTwo, startGainOne, startGainTwo, output, chunkSize);
+            }
+        }
+
+        if (endPanGainsOne != panGainsOne)
+        {
+            std::copy_n(nextPanGainsOne, panner.getNumChannels(), panGainsOne);
+            lastPanOne = next.panOne;
+        }
+
+        if (endPanGainsTwo != panGainsTwo)
+        {
+            std::copy_n(nextPanGainsTwo, panner.getNumChannels(), panGainsTwo);
+            lastPanTwo = next.panTwo;
+        }
+
+        current = next;
+        chunkStart += chunkSize;
+    }
+
+    for (int channel = numPannedChannels; channel < numChannels; ++channel)
+        buffer.clear(channel, 0, numSamples);
+
+    if (identicalTones)
+        oscillatorTwo = oscillatorOne;
+
+    sampleClock += static_cast<std::uint64_t>(numSamples);
+    shaperTables.release();
+    morphSlots.unpin();
+    activeMorph = nullptr;
+}
+
+void DualToneEngine::handleMidiMessage(const juce::MidiMessage& message) noexcept
+{
+    if (message.isNoteOn())
+        voices.noteOn(message.getNoteNumber(), message.getFloatVelocity());
+    else if (message.isNoteOff())
+        voices.noteOff(message.getNoteNumber());
+    else if (message.isAllNotesOff())
+        voices.releaseAll();
+    else if (message.isAllSoundOff())
+        voices.reset();
+    else if (message.isProgramChange())
+        presets.requestSwitch(message.getProgramChangeNumber());
+}
+
+void DualToneEngine::applyPendingPreset() noexcept
+{
+    const auto* preset = presets.takePendingSwitch();
+
+    if (preset == nullptr)
+        return;
+
+    // The ramps glide to the new values as they would for any other parameter change. The
+    // parameters themselves belong to the host; the message thread brings them up to date
+    parameterSnapshot.overrideValues(preset->state.values);
+    targetSettingsNeedUpdate = true;
+
+    // Installed with the rest of the block's tone bank work, gliding like a published layout
+    pendingPresetToneBank = &preset->state.toneBank;
+    toneBankEnabled = preset->state.toneBank.numPartials > 0;
+}
+
+void DualToneEngine::installToneBankLayout(const ToneBankLayout& layout, bool midiVoices) noexcept
+{
+    // The bank works out the new weights for the current panner; recomputing them later would cut the glide short
+    toneBankGainsNeedUpdate = false;
+
+    // Nothing is playing to glide from after prepare(), and MIDI voices do not play the bank
+    if (toneBankJumpsToLayout || midiVoices)
+    {
+        toneBank.jumpToLayout(layout, panner);
+        toneBankHandingOver = false;
+        return;
+    }
+
+    // The Center/Spread pair as it sounds now, as a two-partial bank: switches between the pair and
+    // a bank glide from or to it
+    const auto settings = getToneSettings(false);
+    const auto pair = ToneBankLayout::dualTone(settings.spread,
+                                               settings.gainOne / settings.toneGain,
+                                               settings.gainTwo / settings.toneGain,
+                                               settings.panOne,
+                                               settings.panTwo);
+    const auto bankPlaying = toneBank.getNumPartials() > 0;
+
+    if (layout.numPartials <= 0)
+    {
+        // The pair takes over from the oscillators once the bank has become it
+        if (bankPlaying)
+        {
+            toneBank.setLayout(pair, panner);
+            toneBankHandingOver = true;
+        }
+
+        return;
+    }
+
+    if (! bankPlaying)
+    {
+        toneBank.jumpToLayout(pair, panner);
+        toneBank.setPhase(0, oscillatorOne.getFixedPhase());
+        toneBank.setPhase(1, oscillatorTwo.getFixedPhase());
+    }
+
+    toneBank.setLayout(layout, panner);
+    toneBankHandingOver = false;
+}
+
+void DualToneEngine::finishToneBankHandover() noexcept
+{
+    if (! toneBankHandingOver || toneBank.isRamping())
+        return;
+
+    // The bank's two partials are the pair by now, so the oscillators carry on from their phases
+    oscillatorOne.setFixedPhase(toneBank.getPhase(0));
+    oscillatorTwo.setFixedPhase(toneBank.getPhase(1));
+    toneBank.jumpToLayout({}, panner);
+    toneBankHandingOver = false;
+    shaperStageNeedsPriming = true;
+}
+
+template <typename BaseRateShaper, typename OversampledShaper>
+void DualToneEngine::primeShaperStage(BaseRateShaper& shapeBaseRate,
+                                      OversampledShaper& shapeOversampled,
+                                      int harmonicsOne,
+                                      int harmonicsTwo)
+{
+    shaperOversampler.reset();
+
+    // MIDI voices have no deterministic past to replay, so their delay line simply starts out silent
+    if (shaperOversampler.getLatencyInSamples(activeOversamplingStage) == 0 || midiVoiceMode)
+        return;
+
+    // The tones are deterministic, so re-render the stretch just before the current phase and feed it
+    // through the newly selected path. Its filters or delay line then hold exactly what continuous
+    // operation would have left there, and the switch does not click.
+    const auto warmUpLength = shaperOversampler.getWarmUpLength(activeOversamplingStage);
+
+    auto historyOne = oscillatorOne;
+    auto historyTwo = oscillatorTwo;
+    const auto warmUpSteps = static_cast<std::uint64_t>(warmUpLength);
+    historyOne.setFixedPhase(oscillatorOne.getFixedPhase() - oscillatorOne.getFixedStep() * warmUpSteps);
+    historyTwo.setFixedPhase(oscillatorTwo.getFixedPhase() - oscillatorTwo.getFixedStep() * warmUpSteps);
+
+    double waveOne[renderChunkSize];
+    double waveTwo[renderChunkSize];
+
+    for (int done = 0; done < warmUpLength; done += renderChunkSize)
+    {
+        const auto chunkSize = juce::jmin(renderChunkSize, warmUpLength - done);
+
+        historyOne.render(waveOne, chunkSize);
+        historyTwo.render(waveTwo, chunkSize);
+
+        if (oversamplingEngaged)
+        {
+            shaperOversampler.processOversampled(activeOversamplingStage, waveOne, waveTwo, chunkSize, shapeOversampled);
+        }
+        else
+        {
+            shapeBaseRate(waveOne, chunkSize, harmonicsOne);
+            shapeBaseRate(waveTwo, chunkSize, harmonicsTwo);
+            shaperOversampler.processBypassed(activeOversamplingStage, waveOne, waveTwo, chunkSize);
+        }
+    }
+}
+
+void DualToneEngine::seekTo(juce::int64 samplePosition) noexcept
+{
+    pendingSeekPosition = juce::jmax(static_cast<juce::int64>(0), samplePosition);
+}
+
+void DualToneEngine::setMorphStates(const std::vector<PluginState>& states)
+{
+    // Build the tables first, so publishing is only a move
+    MorphPath path;
+    path.build(states, baseToneGainDb);
+
+    auto& slot = morphSlots.beginUpdate();
+    slot = std::move(path);
+    slot.revision = ++publishedMorphRevision;
+    morphSlots.publish();
+}
+
+void DualToneEngine::setToneBank(const ToneBankLayout& layout)
+{
+    const juce::ScopedLock lock(toneBankPublishLock);
+
+    auto& slot = toneBankSlots.beginUpdate();
+    slot = layout;
+    slot.numPartials = juce::jlimit(0, ToneBankLayout::maxPartials, layout.numPartials);
+    slot.revision = ++publishedToneBankRevision;
+    toneBankSlots.publish();
+
+    toneBankEnabled = slot.numPartials > 0;
+    currentToneBankLayout = slot;
+}
+
+ToneBankLayout DualToneEngine::getToneBankLayout() const
+{
+    const juce::ScopedLock lock(toneBankPublishLock);
+    return currentToneBankLayout;
+}
+
+template void DualToneEngine::process(juce::AudioBuffer<float>&, const juce::MidiBuffer&);
+template void DualToneEngine::process(juce::AudioBuffer<double>&, const juce::MidiBuffer&);
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "ChannelPanner.h"
+#include "MorphPath.h"
+#include "ParameterRamp.h"
+#include "ParameterSnapshot.h"
+#include "PeriodicRenderCache.h"
+#include "PluginState.h"
+#include "PresetBank.h"
+#include "RealtimeResourceSlots.h"
+#include "ShaperOversampler.h"
+#include "SineOscillator.h"
+#include "ToneBank.h"
+#include "VoicePool.h"
+#include "WaveshaperTableCache.h"
+
+// The tone generator itself: everything the plugin does per block, without juce::AudioProcessor.
+//
+// The engine reads its parameters from atomics its owner provides, in PluginState order and in
+// each parameter's own units: the plugin hands it the value tree's, headless code plain ones.
+// It renders into whatever channels it is given, so the caller owns every buffer.
+//
+// prepare(), setChannelLayout() and the setters that build tables run off the audio thread and
+// never concurrently with process(). process() allocates nothing. The engine starts no threads
+// of its own: attach it to a worker for the background table and period renders, or run it
+// non-realtime, which builds shaper tables inline and skips the period cache.
+class DualToneEngine
+{
+public:
+    using ParameterValues = std::array<std::atomic<float>*, PluginState::numParameters>;
+
+    // Level of each tone at 0 dB gain, before attenuation and panning.
+    static constexpr double baseToneGainDb = -12.0;
+
+    DualToneEngine() = default;
+
+    // Must be called before anything else. The values must outlive the engine.
+    void setParameterValues(const ParameterValues& values) noexcept;
+
+    // Parameter changes made while the returned batch is in scope reach process() together.
+    [[nodiscard]] ParameterSnapshot::ScopedBatch batchParameterChanges() noexcept
+    {
+        return ParameterSnapshot::ScopedBatch(parameterSnapshot);
+    }
+
+    // A preset switched to by process() overrides the parameter values inside the engine until the
+    // parameters catch up. Read the generation before writing them, and release it once written.
+    std::uint32_t getPresetOverrideGeneration() const noexcept { return parameterSnapshot.getOverrideGeneration(); }
+    void releasePresetOverride(std::uint32_t generation) noexcept { parameterSnapshot.releaseOverride(generation); }
+
+    // Lets the worker build shaper tables and render still drones ahead of the audio thread.
+    void attachWorker(juce::TimeSliceThread& worker);
+    void detachWorker(juce::TimeSliceThread& worker);
+
+    // Runs one time slice of that background work on the calling thread instead, for an engine
+    // driven without a worker. Never while a worker is attached, nor during process().
+    void runBackgroundWork();
+
+    void prepare(double sampleRate);
+
+    // The panner follows the layout; any other set with one channel is mono.
+    void setChannelLayout(const juce::AudioChannelSet& layout);
+
+    // Non-realtime processing never waits for the worker: tables are built inline and every block is synthesised.
+    void setNonRealtime(bool shouldBeNonRealtime) noexcept { nonRealtime = shouldBeNonRealtime; }
+
+    // Renders numSamples into the buffer's channels, replacing their contents. MIDI notes play in
+    // MIDI voice mode; program changes select a preset from the bank.
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages);
+
+    // Whether the last block was played from a cached output period rather than synthesised.
+    // Audio thread, or between blocks.
+    bool isPlayingFromCache() const noexcept { return playingFromCache; }
+
+    // See DualToneGeneratorAudioProcessor::seekTo.
+    void seekTo(juce::int64 samplePosition) noexcept;
+
+    // Latency of the current oversampling choice, from the latest parameter values. Any thread.
+    int getLatencyInSamples() const noexcept;
+
+    // Whether a tone bank plays instead of the Center/Spread pair, from the latest layout and voice
+    // mode. Spread, the pans and the attenuations have no effect while it does. Any thread.
+    bool isToneBankActive() const noexcept;
+
+    // Installs a tone bank layout; see DualToneGeneratorAudioProcessor::setToneBank. Any thread but the audio thread.
+    void setToneBank(const ToneBankLayout& layout);
+    ToneBankLayout getToneBankLayout() const;
+
+    // See DualToneGeneratorAudioProcessor::setMorphStates.
+    void setMorphStates(const std::vector<PluginState>& states);
+
+    PresetBank& getPresetBank() noexcept { return presets; }
+
+private:
+    void handleMidiMessage(const juce::MidiMessage& message) noexcept;
+
+    template <typename BaseRateShaper, typename OversampledShaper>
+    void primeShaperStage(BaseRateShaper& shapeBaseRate,
+                          OversampledShaper& shapeOversampled,
+                          int harmonicsOne,
+                          int harmonicsTwo);
+
+    // Audio thread: overrides the parameter snapshot and the tone bank with a requested preset.
+    void applyPendingPreset() noexcept;
+
+    // Audio thread: glides the bank to a new layout, from or back to the Center/Spread pair if
+    // either side has no partials.
+    void installToneBankLayout(const ToneBankLayout& layout, bool midiVoices) noexcept;
+
+    // Hands the tones back to the pair's oscillators once a bank gliding to the pair has arrived.
+    void finishToneBankHandover() noexcept;
+
+    // Everything the tone pipeline derives from the smoothed parameters at one point in time.
+    struct ToneSettings
+    {
+        double centerFrequency = 0.0;
+        double spread = 0.0;
+        double frequencyOne = 0.0;
+        double frequencyTwo = 0.0;
+        double incrementOne = 0.0;
+        double incrementTwo = 0.0;
+        double toneGain = 0.0;
+        double gainOne = 0.0;
+        double gainTwo = 0.0;
+        double panOne = 0.0;
+        double panTwo = 0.0;
+        double driveDb = 0.0;
+        double typeMix = 0.0;
+        double morphPosition = 0.0;
+    };
+
+    enum SmoothedParameter
+    {
+        smoothedCenterFrequency,
+        smoothedSpread,
+        smoothedPanOne,
+        smoothedPanTwo,
+        smoothedAttenuationOne,
+        smoothedAttenuationTwo,
+        smoothedGain,
+        smoothedDrive,
+        smoothedShapeType,
+        smoothedMorph,
+        numSmoothedParameters
+    };
+
+    void setRampTargets();
+    int getSamplesToNextRampEnd(int maxSamples) const;
+    ToneSettings getToneSettings(bool atTarget) const;
+
+    // Render chunks end on morph states, so each chunk interpolates between the ends of one segment.
+    int getSamplesToNextMorphState(int maxSamples) const;
+    void updateMorphStatePanGains() noexcept;
+    void getMorphPanGains(double position, double* gainsOne, double* gainsTwo) const noexcept;
+
+    ParameterValues parameterValues {};
+
+    // Taken at the start of each block. The target tone settings are derived from it, and only
+    // worked out again when its version, the morph path or the sample rate changes.
+    ParameterSnapshot parameterSnapshot;
+    ToneSettings targetSettings;
+    bool targetSettingsNeedUpdate = true;
+    bool morphWasActive = false;
+
+    double currentSampleRate = 44100.0;
+    bool nonRealtime = false;
+    SineOscillator oscillatorOne;
+    SineOscillator oscillatorTwo;
+    VoicePool voices;
+    bool midiVoiceMode = false;
+    juce::int64 pendingSeekPosition = -1;
+
+    ToneBank toneBank;
+    RealtimeResourceSlots<ToneBankLayout> toneBankSlots;
+    juce::CriticalSection toneBankPublishLock;
+    std::uint32_t publishedToneBankRevision = 0;
+    std::uint32_t appliedToneBankRevision = 0;
+    std::atomic<bool> toneBankEnabled { false };
+    bool toneBankGainsNeedUpdate = true;
+    bool toneBankJumpsToLayout = true;
+    bool toneBankHandingOver = false;
+    const ToneBankLayout* pendingPresetToneBank = nullptr;
+
+    // The last published layout, kept off the audio thread for saving and new presets.
+    ToneBankLayout currentToneBankLayout;
+
+    // The morph path is pinned for the duration of each block; activeMorph is only set while it is.
+    RealtimeResourceSlots<MorphPath> morphSlots;
+    std::uint32_t publishedMorphRevision = 0;
+    std::uint32_t appliedMorphRevision = 0;
+    const MorphPath* activeMorph = nullptr;
+    double morphStatePanGainsOne[MorphPath::maxStates][ChannelPanner::maxChannels] {};
+    double morphStatePanGainsTwo[MorphPath::maxStates][ChannelPanner::maxChannels] {};
+    bool morphStatePanGainsNeedUpdate = true;
+
+    PresetBank presets;
+
+    // Linear ramps towards the latest parameter values, in the units the parameters use (Hz, dB, pan).
+    ParameterRamp parameterRamps[numSmoothedParameters];
+
+    WaveshaperTableCache shaperTables;
+
+    // Non-realtime renders cannot wait for the worker, so they build the table on the processing thread instead.
+    WaveshaperTable offlineShaperTable;
+    PeriodicRenderCache renderCache;
+    bool playingFromCache = false;
+
+    // Samples processed since construction; positions cached periods against the oscillator phases.
+    std::uint64_t sampleClock = 0;
+
+    ChannelPanner panner;
+    double panGainsOne[ChannelPanner::maxChannels] {};
+    double panGainsTwo[ChannelPanner::maxChannels] {};
+    double lastPanOne = 0.0;
+    double lastPanTwo = 0.0;
+    bool panGainsNeedUpdate = true;
+
+    ShaperOversampler shaperOversampler;
+    int activeOversamplingStage = 0;
+    bool oversamplingEngaged = false;
+    bool shaperStageNeedsPriming = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DualToneEngine)
+};
@@ -0,0 +1,62 @@
+#include "EditorAssets.h"
+
+#include "BinaryData.h"
+
+namespace
+{
+struct AssetData
+{
+    const char* data;
+    int size;
+};
+
+AssetData getAssetData(EditorAssets::Asset asset)
+{
+    switch (asset)
+    {
+        case EditorAssets::knobLarge: return { BinaryData::cog_knob_large_svg, BinaryData::cog_knob_large_svgSize };
+        case EditorAssets::knobGreen: return { BinaryData::cog_knob_green_svg, BinaryData::cog_knob_green_svgSize };
+        case EditorAssets::knobBlue: return { BinaryData::cog_knob_blue_svg, BinaryData::cog_knob_blue_svgSize };
+        case EditorAssets::knobGray: return { BinaryData::cog_knob_gray_svg, BinaryData::cog_knob_gray_svgSize };
+        case EditorAssets::knobDark: return { BinaryData::cog_knob_dark_svg, BinaryData::cog_knob_dark_svgSize };
+        case EditorAssets::logo: return { BinaryData::logo_svg, BinaryData::logo_svgSize };
+        case EditorAssets::vcoCircuit: return { BinaryData::vco_circuit_svg, BinaryData::vco_circuit_svgSize };
+        case EditorAssets::numAssets: break;
+    }
+
+    jassertfalse;
+    return { nullptr, 0 };
+}
+} // namespace
+
+const juce::Drawable* EditorAssets::getDrawable(Asset asset)
+{
+    const juce::ScopedLock scopedLock(lock);
+    const auto index = static_cast<size_t>(asset);
+
+    if (! parsed[index])
+    {
+        const auto assetData = getAssetData(asset);
+
+        if (assetData.data != nullptr)
+            drawables[index] = juce::Drawable::createFromImageData(assetData.data, static_cast<size_t>(assetData.size));
+
+        parsed[index] = true;
+        ++numParsed;
+    }
+
+    return drawables[index].get();
+}
+
+KnobImageAtlas& EditorAssets::getKnobAtlas(Asset asset)
+{
+    const auto* drawable = getDrawable(asset);
+
+    const juce::ScopedLock scopedLock(lock);
+    auto& atlas = atlases[static_cast<size_t>(asset)];
+
+    if (atlas == nullptr)
+        atlas = std::make_unique<KnobImageAtlas>(drawable);
+
+    return *atlas;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "KnobImageAtlas.h"
+
+// Parsed SVG assets and dial rasters shared by every editor in the process.
+//
+// Held through juce::SharedResourcePointer. Each processor keeps one reference, so the assets
+// outlive a closed editor and a session with many instances parses each SVG once. Assets are
+// parsed on first use; lookups are safe from any thread and the returned objects live as long
+// as the cache. The drawables are never modified after parsing. The knob atlases render
+// lazily and, like all painting, may only be drawn from the message thread.
+class EditorAssets
+{
+public:
+    enum Asset
+    {
+        knobLarge,
+        knobGreen,
+        knobBlue,
+        knobGray,
+        knobDark,
+        logo,
+        vcoCircuit,
+        numAssets
+    };
+
+    EditorAssets() = default;
+
+    const juce::Drawable* getDrawable(Asset asset);
+
+    // Raster layers of a knob asset, shared by every dial that uses it.
+    KnobImageAtlas& getKnobAtlas(Asset asset);
+
+    // How many SVGs have been parsed so far.
+    int getNumParsed() const noexcept { return numParsed.load(); }
+
+private:
+    juce::CriticalSection lock;
+    std::array<std::unique_ptr<juce::Drawable>, numAssets> drawables;
+    std::array<bool, numAssets> parsed {};
+    std::array<std::unique_ptr<KnobImageAtlas>, numAssets> atlases;
+    std::atomic<int> numParsed { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EditorAssets)
+};
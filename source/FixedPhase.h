@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Oscillator phase as an unsigned 64-bit fraction of one cycle.
+//
+// Advancing by a per-sample step is an integer add that wraps for free on overflow and
+// is exact, so a phase that runs for days carries no accumulated rounding, and the phase
+// n samples on is simply phase + n * step in the same modular arithmetic. Steps resolve
+// 2^-64 cycles per sample, far below anything audible. Rotator coefficients are derived
+// from the quantised step, so rendered frequency and accumulator never drift apart.
+namespace FixedPhase
+{
+using Value = std::uint64_t;
+
+constexpr double twoPi = 6.283185307179586476925286766559;
+
+// 2^64, one full cycle.
+constexpr double fullScale = 18446744073709551616.0;
+
+inline Value fromCycles(double cycles) noexcept
+{
+    cycles -= std::floor(cycles);
+    const auto scaled = cycles * fullScale;
+    return scaled < fullScale ? static_cast<Value>(scaled) : 0;
+}
+
+inline Value fromRadians(double radians) noexcept
+{
+    return fromCycles(radians / twoPi);
+}
+
+inline double toRadians(Value phase) noexcept
+{
+    return static_cast<double>(phase) * (twoPi / fullScale);
+}
+
+// Phase after numSamples steps from phase; exact for any sample count.
+inline Value advance(Value phase, Value step, std::uint64_t numSamples) noexcept
+{
+    return phase + step * numSamples;
+}
+} // namespace FixedPhase
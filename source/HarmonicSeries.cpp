@@ -0,0 +1,106 @@
+#include "HarmonicSeries.h"
+
+#include "WaveshaperTable.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr double twoPi = 6.283185307179586476925286766559;
+
+// Points per cycle used to measure the series; far above the highest harmonic kept.
+constexpr int analysisSize = 1024;
+
+// Harmonics below this level relative to the fundamental are dropped (about -140 dB).
+constexpr double significanceThreshold = 1.0e-7;
+
+constexpr int renderSubBlock = 64;
+} // namespace
+
+void HarmonicSeries::build(const WaveshaperCurve& curve)
+{
+    double shaped[analysisSize];
+    double sines[analysisSize];
+
+    for (int j = 0; j < analysisSize; ++j)
+    {
+        sines[j] = std::sin(twoPi * static_cast<double>(j) / static_cast<double>(analysisSize));
+        shaped[j] = curve.evaluate(sines[j]);
+    }
+
+    for (int index = 0; index < maxOddHarmonics; ++index)
+    {
+        const auto harmonic = 2 * index + 1;
+        double sum = 0.0;
+
+        // sin(k * theta_j) is read back from the sine table at index (k * j) mod N
+        for (int j = 0; j < analysisSize; ++j)
+            sum += shaped[j] * sines[(harmonic * j) % analysisSize];
+
+        amplitudes[index] = sum * (2.0 / static_cast<double>(analysisSize));
+    }
+
+    const auto reference = std::abs(amplitudes[0]);
+    numSignificant = 1;
+
+    for (int index = maxOddHarmonics - 1; index > 0; --index)
+    {
+        if (std::abs(amplitudes[index]) > reference * significanceThreshold)
+        {
+            numSignificant = index + 1;
+            break;
+        }
+    }
+}
+
+int HarmonicSeries::getNumHarmonicsBelow(double frequency, double sampleRate) const noexcept
+{
+    if (frequency <= 0.0)
+        return numSignificant;
+
+    const auto nyquist = 0.5 * sampleRate;
+    const auto highestHarmonic = static_cast<int>(std::ceil(nyquist / frequency)) - 1;
+    const auto oddBelowNyquist = (highestHarmonic + 1) / 2;
+    return oddBelowNyquist < numSignificant ? oddBelowNyquist : numSignificant;
+}
+
+template <typename SampleType>
+void HarmonicSeries::render(const SampleType* input, SampleType* output, int numSamples, int numOddHarmonics) const noexcept
+{
+    for (int start = 0; start < numSamples; start += renderSubBlock)
+    {
+        const auto count = numSamples - start < renderSubBlock ? numSamples - start : renderSubBlock;
+        const auto* sine = input + start;
+        auto* out = output + start;
+
+        SampleType twoCosTwoTheta[renderSubBlock];
+        SampleType next[renderSubBlock];
+        SampleType afterNext[renderSubBlock];
+
+        for (int i = 0; i < count; ++i)
+        {
+            twoCosTwoTheta[i] = SampleType(2) - SampleType(4) * sine[i] * sine[i];
+            next[i] = SampleType(0);
+            afterNext[i] = SampleType(0);
+        }
+
+        for (int index = numOddHarmonics - 1; index >= 0; --index)
+        {
+            const auto amplitude = static_cast<SampleType>(amplitudes[index]);
+
+            for (int i = 0; i < count; ++i)
+            {
+                const auto current = amplitude + twoCosTwoTheta[i] * next[i] - afterNext[i];
+                afterNext[i] = next[i];
+                next[i] = current;
+            }
+        }
+
+        // sum = sin(theta) * (beta_0 + beta_1) for the odd-harmonic Clenshaw recurrence
+        for (int i = 0; i < count; ++i)
+            out[i] = sine[i] * (next[i] + afterNext[i]);
+    }
+}
+
+template void HarmonicSeries::render<float>(const float*, float*, int, int) const noexcept;
+template void HarmonicSeries::render<double>(const double*, double*, int, int) const noexcept;
@@ -0,0 +1,38 @@
+#pragma once
+
+struct WaveshaperCurve;
+
+// Odd-harmonic Fourier series of a waveshaper driven by a pure sine.
+//
+// The shaper is an odd function and its input is sin(theta), so its output is exactly
+//
+//     shape(sin(theta)) = sum over odd k of b_k * sin(k * theta)
+//
+// build() measures the b_k once per drive/type setting. render() then resynthesises the
+// shaped tone from the oscillator's sine using only the harmonics the caller allows,
+// which gives an alias-free result with no oversampling. The sum is evaluated with a
+// Clenshaw recurrence in cos(2 * theta) = 1 - 2 * sin^2(theta), so the cost is one
+// multiply-add per harmonic per sample and needs no other trigonometry.
+class HarmonicSeries
+{
+public:
+    static constexpr int maxOddHarmonics = 64;
+
+    void build(const WaveshaperCurve& curve);
+
+    // Number of odd harmonics whose amplitude is still significant for this curve.
+    int getNumSignificantHarmonics() const noexcept { return numSignificant; }
+
+    // Number of odd harmonics worth rendering for a tone at this frequency: significant and below Nyquist.
+    int getNumHarmonicsBelow(double frequency, double sampleRate) const noexcept;
+
+    double getAmplitude(int oddHarmonicIndex) const noexcept { return amplitudes[oddHarmonicIndex]; }
+
+    // Rewrites a block of sin(theta) values as the band-limited shaped tone. input and output may alias.
+    template <typename SampleType>
+    void render(const SampleType* input, SampleType* output, int numSamples, int numOddHarmonics) const noexcept;
+
+private:
+    double amplitudes[maxOddHarmonics] {};
+    int numSignificant = 0;
+};
@@ -0,0 +1,251 @@
+#include "KnobImageAtlas.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+// Renders one layer covering area (slider coordinates) at pixelScale physical pixels per point.
+template <typename PaintFunction>
+juce::Image renderLayer(juce::Rectangle<int> area, float pixelScale, PaintFunction&& paint)
+{
+    juce::Image image(juce::Image::ARGB,
+                      juce::jmax(1, juce::roundToInt(static_cast<float>(area.getWidth()) * pixelScale)),
+                      juce::jmax(1, juce::roundToInt(static_cast<float>(area.getHeight()) * pixelScale)),
+                      true);
+
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::translation(static_cast<float>(-area.getX()), static_cast<float>(-area.getY()))
+                       .scaled(pixelScale));
+    paint(g);
+    return image;
+}
+
+void blit(juce::Graphics& g, const juce::Image& image, juce::Rectangle<int> area, float pixelScale)
+{
+    g.drawImageTransformed(image,
+                           juce::AffineTransform::scale(1.0f / pixelScale)
+                               .translated(static_cast<float>(area.getX()), static_cast<float>(area.getY())));
+}
+} // namespace
+
+bool KnobImageAtlas::Geometry::operator==(const Geometry& other) const noexcept
+{
+    return bounds == other.bounds
+           && rotaryStartAngle == other.rotaryStartAngle
+           && rotaryEndAngle == other.rotaryEndAngle
+           && uiScale == other.uiScale
+           && pixelScale == other.pixelScale
+           && outlineColour == other.outlineColour
+           && accentColour == other.accentColour;
+}
+
+struct KnobImageAtlas::Layers
+{
+    Geometry geometry;
+
+    // Dial measurements in slider coordinates
+    juce::Rectangle<float> knobBounds;
+    juce::Point<float> centre;
+    float trackRadius = 0.0f;
+    float trackThickness = 0.0f;
+
+    // Pixel-aligned areas the images cover: everything including the shadow, and the knob alone
+    juce::Rectangle<int> area;
+    juce::Rectangle<int> knobArea;
+
+    juce::Image track;
+    juce::Image valueArc;
+    juce::Image shadowAndTicks;
+    juce::Image knob;
+
+    float frameStep = 0.0f;
+    std::vector<juce::Image> frames;
+    size_t frameBytes = 0;
+    size_t usedFrameBytes = 0;
+
+    // Draw count at which each frame was last drawn, for least-recently-drawn eviction
+    std::vector<std::uint64_t> frameLastDrawn;
+    std::uint64_t drawCount = 0;
+};
+
+KnobImageAtlas::KnobImageAtlas(const juce::Drawable* knobDrawableToUse)
+    : knobDrawable(knobDrawableToUse)
+{
+}
+
+KnobImageAtlas::~KnobImageAtlas() = default;
+
+KnobImageAtlas::Layers& KnobImageAtlas::getLayers(const Geometry& geometry)
+{
+    for (auto& layers : cachedLayers)
+        if (layers->geometry == geometry)
+            return *layers;
+
+    auto layers = std::make_unique<Layers>();
+    layers->geometry = geometry;
+
+    const auto bounds = geometry.bounds.toFloat().reduced(6.0f);
+    const auto diameter = juce::jmin(bounds.getWidth(), bounds.getHeight());
+    const auto knobBounds = juce::Rectangle<float>(diameter, diameter).withCentre(bounds.getCentre());
+    const auto centre = knobBounds.getCentre();
+    const auto knobRadius = knobBounds.getWidth() * 0.5f;
+    const auto trackRadius = knobRadius - 14.0f;
+    const auto trackThickness = juce::jmax(knobBounds.getWidth() * 0.045f, 3.0f);
+
+    layers->knobBounds = knobBounds;
+    layers->centre = centre;
+    layers->trackRadius = trackRadius;
+    layers->trackThickness = trackThickness;
+
+    const auto shadowRadius = juce::jmax(juce::roundToInt(16.0f * geometry.uiScale), juce::roundToInt(knobRadius * 0.18f));
+    const auto shadowOffsetY = juce::jmax(juce::roundToInt(9.0f * geometry.uiScale), juce::roundToInt(knobRadius * 0.10f));
+
+    layers->knobArea = knobBounds.getSmallestIntegerContainer();
+    layers->area = knobBounds.expanded(static_cast<float>(shadowRadius + shadowOffsetY + 2))
+                       .getSmallestIntegerContainer()
+                       .getUnion(geometry.bounds);
+
+    const auto start = geometry.rotaryStartAngle;
+    const auto end = geometry.rotaryEndAngle;
+    const juce::PathStrokeType stroke(trackThickness, juce::PathStrokeType::curved, juce::PathStrokeType::rounded);
+
+    auto strokeArc = [&](juce::Graphics& g, juce::Colour colour)
+    {
+        juce::Path arc;
+        arc.addCentredArc(centre.x, centre.y, trackRadius, trackRadius, 0.0f, start, end, true);
+        g.setColour(colour);
+        g.strokePath(arc, stroke);
+    };
+
+    layers->track = renderLayer(layers->area, geometry.pixelScale, [&](juce::Graphics& g)
+                                { strokeArc(g, geometry.outlineColour.withAlpha(0.20f)); });
+
+    layers->valueArc = renderLayer(layers->area, geometry.pixelScale, [&](juce::Graphics& g)
+                                   { strokeArc(g, geometry.accentColour.withAlpha(0.75f)); });
+
+    layers->shadowAndTicks = renderLayer(layers->area, geometry.pixelScale, [&](juce::Graphics& g)
+    {
+        juce::Path knobShadowPath;
+        knobShadowPath.addEllipse(knobBounds);
+
+        juce::DropShadow knobShadow { juce::Colours::black.withAlpha(0.16f), shadowRadius, { 0, shadowOffsetY } };
+        knobShadow.drawForPath(g, knobShadowPath);
+
+        auto drawTick = [&](float tickAngle, float thickness, float alpha)
+        {
+            const auto outer = centre.getPointOnCircumference(trackRadius + 10.0f, tickAngle);
+            const auto inner = centre.getPointOnCircumference(trackRadius - 6.0f, tickAngle);
+            g.setColour(geometry.outlineColour.withAlpha(alpha));
+            g.drawLine({ inner, outer }, thickness);
+        };
+
+        drawTick(start, 1.6f, 0.35f);
+        drawTick(end, 1.6f, 0.35f);
+        drawTick((start + end) * 0.5f, 1.8f, 0.45f);
+    });
+
+    layers->knob = renderLayer(layers->knobArea, geometry.pixelScale, [&](juce::Graphics& g)
+    {
+        if (knobDrawable != nullptr)
+        {
+            knobDrawable->drawWithin(g, knobBounds, juce::RectanglePlacement::stretchToFit, 1.0f);
+        }
+        else
+        {
+            g.setColour(juce::Colours::darkgrey);
+            g.fillEllipse(knobBounds);
+        }
+    });
+
+    // Consecutive frames move the knob rim by one physical pixel, or a little more on large knobs
+    const auto rimRadius = juce::jmax(1.0f, knobRadius * geometry.pixelScale);
+    const auto sweep = std::abs(end - start);
+    const auto numFrames = juce::jlimit(2, maxFramesPerSweep, static_cast<int>(std::ceil(sweep * rimRadius)) + 1);
+    layers->frameStep = (end - start) / static_cast<float>(numFrames - 1);
+    layers->frames.resize(static_cast<size_t>(numFrames));
+    layers->frameLastDrawn.resize(static_cast<size_t>(numFrames));
+    layers->frameBytes = static_cast<size_t>(layers->knob.getWidth()) * static_cast<size_t>(layers->knob.getHeight()) * 4;
+
+    cachedLayers.insert(cachedLayers.begin(), std::move(layers));
+
+    if (cachedLayers.size() > static_cast<size_t>(maxCachedGeometries))
+        cachedLayers.pop_back();
+
+    return *cachedLayers.front();
+}
+
+void KnobImageAtlas::draw(juce::Graphics& g, const Geometry& geometry, float sliderPos)
+{
+    auto& layers = getLayers(geometry);
+    const auto pixelScale = geometry.pixelScale;
+    const auto start = geometry.rotaryStartAngle;
+    const auto angle = start + sliderPos * (geometry.rotaryEndAngle - start);
+
+    blit(g, layers.track, layers.area, pixelScale);
+
+    {
+        // The value arc is the full arc clipped to the swept wedge, plus a disc that rounds off its moving end
+        const auto capRadius = layers.trackThickness * 0.5f;
+        const auto capAngle = layers.trackThickness / juce::jmax(1.0f, layers.trackRadius);
+        const auto outerRadius = layers.trackRadius + layers.trackThickness;
+        const auto endPoint = layers.centre.getPointOnCircumference(layers.trackRadius, angle);
+
+        juce::Path clip;
+        clip.addPieSegment(juce::Rectangle<float>(outerRadius * 2.0f, outerRadius * 2.0f).withCentre(layers.centre),
+                           start - capAngle,
+                           angle,
+                           0.0f);
+        clip.addEllipse(juce::Rectangle<float>(capRadius * 2.0f, capRadius * 2.0f).withCentre(endPoint));
+
+        juce::Graphics::ScopedSaveState state(g);
+        g.reduceClipRegion(clip);
+        blit(g, layers.valueArc, layers.area, pixelScale);
+    }
+
+    blit(g, layers.shadowAndTicks, layers.area, pixelScale);
+
+    const auto frameIndex = juce::jlimit(0,
+                                         static_cast<int>(layers.frames.size()) - 1,
+                                         layers.frameStep != 0.0f ? juce::roundToInt((angle - start) / layers.frameStep) : 0);
+    auto& frame = layers.frames[static_cast<size_t>(frameIndex)];
+
+    if (frame.isNull())
+    {
+        // A drag only revisits angles near the current one, so the frames it left long ago go first
+        while (layers.usedFrameBytes > 0 && layers.usedFrameBytes + layers.frameBytes > frameBudgetBytes)
+        {
+            auto oldest = layers.frames.size();
+
+            for (size_t index = 0; index < layers.frames.size(); ++index)
+                if (! layers.frames[index].isNull()
+                    && (oldest == layers.frames.size() || layers.frameLastDrawn[index] < layers.frameLastDrawn[oldest]))
+                    oldest = index;
+
+            layers.frames[oldest] = {};
+            layers.usedFrameBytes -= layers.frameBytes;
+        }
+
+        const auto frameAngle = start + static_cast<float>(frameIndex) * layers.frameStep;
+        const auto pivot = (layers.centre - layers.knobArea.getPosition().toFloat()) * pixelScale;
+
+        frame = juce::Image(juce::Image::ARGB, layers.knob.getWidth(), layers.knob.getHeight(), true);
+        juce::Graphics frameGraphics(frame);
+        frameGraphics.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+        frameGraphics.drawImageTransformed(layers.knob, juce::AffineTransform::rotation(frameAngle, pivot.x, pivot.y));
+        layers.usedFrameBytes += layers.frameBytes;
+    }
+
+    layers.frameLastDrawn[static_cast<size_t>(frameIndex)] = ++layers.drawCount;
+    blit(g, frame, layers.knobArea, pixelScale);
+}
+
+size_t KnobImageAtlas::getCachedFrameBytes() const noexcept
+{
+    size_t bytes = 0;
+
+    for (const auto& layers : cachedLayers)
+        bytes += layers->usedFrameBytes;
+
+    return bytes;
+}
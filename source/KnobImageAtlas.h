@@ -0,0 +1,61 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <memory>
+#include <vector>
+
+// Pre-rendered layers of one rotary dial, so a repaint only blits images.
+//
+// For each dial geometry (slider bounds, rotary range, UI scale, display scale and colours)
+// the atlas renders the static track, the full value arc, the drop shadow with the tick marks
+// and an unrotated knob at physical pixel resolution. Rotated knob frames are quantised so the
+// knob rim moves by at most one physical pixel between frames, up to maxFramesPerSweep across
+// the rotary range; they are rendered from the unrotated raster the first time each angle is
+// shown and kept up to a memory budget, beyond which the least recently drawn frame goes.
+// Changing any part of the geometry, e.g. by resizing or moving the editor to a display with
+// a different scale, selects or builds another set; only the most recent few are kept.
+class KnobImageAtlas
+{
+public:
+    struct Geometry
+    {
+        juce::Rectangle<int> bounds;
+        float rotaryStartAngle = 0.0f;
+        float rotaryEndAngle = 0.0f;
+        float uiScale = 1.0f;
+        float pixelScale = 1.0f;
+        juce::Colour outlineColour;
+        juce::Colour accentColour;
+
+        bool operator==(const Geometry& other) const noexcept;
+    };
+
+    explicit KnobImageAtlas(const juce::Drawable* knobDrawableToUse);
+    ~KnobImageAtlas();
+
+    // Draws the dial at the given slider position, building the layers for this geometry if needed.
+    void draw(juce::Graphics& g, const Geometry& geometry, float sliderPos);
+
+    // Number of geometries kept at once; dials of one look and feel rarely have more sizes.
+    static constexpr int maxCachedGeometries = 4;
+
+    // Rotated frames across the full rotary range, about one degree apart on a 270 degree dial.
+    static constexpr int maxFramesPerSweep = 256;
+
+    // Memory for rotated frames per geometry; reaching it evicts the least recently drawn frame.
+    static constexpr size_t frameBudgetBytes = 24u << 20;
+
+    // Memory held by rotated frames across all cached geometries.
+    size_t getCachedFrameBytes() const noexcept;
+
+private:
+    struct Layers;
+
+    Layers& getLayers(const Geometry& geometry);
+
+    const juce::Drawable* knobDrawable;
+    std::vector<std::unique_ptr<Layers>> cachedLayers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KnobImageAtlas)
+};
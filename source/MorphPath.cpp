@@ -0,0 +1,97 @@
+#include "MorphPath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+double decibelsToGain(double decibels)
+{
+    return std::pow(10.0, decibels / 20.0);
+}
+} // namespace
+
+void MorphPath::build(const std::vector<PluginState>& stateList, double baseToneGainDb)
+{
+    states.resize(std::min(stateList.size(), static_cast<size_t>(maxStates)));
+
+    for (size_t index = 0; index < states.size(); ++index)
+    {
+        const auto& values = stateList[index].values;
+        auto& state = states[index];
+
+        state.centerFrequency = values[PluginState::centerFreq];
+        state.spread = values[PluginState::spread];
+        state.panOne = values[PluginState::pan1];
+        state.panTwo = values[PluginState::pan2];
+        state.driveDb = values[PluginState::drive];
+        state.typeMix = std::clamp(static_cast<double>(values[PluginState::shapeType]), 0.0, 1.0);
+
+        state.toneGain = decibelsToGain(baseToneGainDb + values[PluginState::gain]);
+        state.gainOne = state.toneGain * decibelsToGain(values[PluginState::atten1]);
+        state.gainTwo = state.toneGain * decibelsToGain(values[PluginState::atten2]);
+
+        state.shaper.build(WaveshaperCurve::fromParameters(values[PluginState::drive], values[PluginState::shapeType]));
+    }
+}
+
+MorphPath::Segment MorphPath::locate(double position) const noexcept
+{
+    const auto numSegments = static_cast<int>(states.size()) - 1;
+    const auto scaled = std::clamp(position, 0.0, 1.0) * static_cast<double>(numSegments);
+    const auto index = std::min(static_cast<int>(scaled), numSegments - 1);
+    return { index, scaled - static_cast<double>(index) };
+}
+
+MorphPath::Shaping MorphPath::getShaping(double startPosition, double endPosition) const noexcept
+{
+    const auto segment = locate(0.5 * (startPosition + endPosition));
+    const auto numSegments = static_cast<double>(states.size() - 1);
+
+    auto weightAt = [&segment, numSegments](double position)
+    {
+        return std::clamp(std::clamp(position, 0.0, 1.0) * numSegments - static_cast<double>(segment.index), 0.0, 1.0);
+    };
+
+    const auto& from = states[static_cast<size_t>(segment.index)].shaper;
+    const auto& to = states[static_cast<size_t>(segment.index) + 1].shaper;
+
+    Shaping shaping;
+    shaping.weightStart = weightAt(startPosition);
+    shaping.weightEnd = weightAt(endPosition);
+
+    const auto& curve = from.getCurve();
+
+    if (to.matches(curve.driveDb, curve.shapeType) || (shaping.weightStart == 0.0 && shaping.weightEnd == 0.0))
+        return { &from, nullptr, 0.0, 0.0 };
+
+    if (shaping.weightStart == 1.0 && shaping.weightEnd == 1.0)
+        return { &to, nullptr, 0.0, 0.0 };
+
+    shaping.from = &from;
+    shaping.to = &to;
+    return shaping;
+}
+
+double MorphPath::getNextStatePosition(double from, double to) const noexcept
+{
+    const auto numSegments = static_cast<double>(states.size() - 1);
+
+    if (to > from)
+        return std::min(to, (std::floor(from * numSegments) + 1.0) / numSegments);
+
+    if (to < from)
+        return std::max(to, (std::ceil(from * numSegments) - 1.0) / numSegments);
+
+    return to;
+}
+
+int MorphPath::getNumHarmonicsBelow(double frequency, double sampleRate) const noexcept
+{
+    auto numHarmonics = 0;
+
+    for (const auto& state : states)
+        numHarmonics = std::max(numHarmonics, state.shaper.getHarmonics().getNumHarmonicsBelow(frequency, sampleRate));
+
+    return numHarmonics;
+}
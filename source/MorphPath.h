@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PluginState.h"
+#include "WaveshaperTable.h"
+
+// Precomputed path through two or more stored states, played by the Morph parameter.
+//
+// Morph 0 plays the first state and 1 the last, with the others evenly spaced in between.
+// Everything that needs pow, tanh or atan is worked out once per state when the path is built:
+// the linear tone gains and a shaper table for each state's drive and type. Between two states
+// the audio thread only interpolates. The phase increments, tone gains and pan gains move
+// linearly, and the shaped tone crossfades between the outputs of the two states' tables.
+// Pan gains depend on the channel layout, so the processor works those out per state when a
+// path or layout arrives, not per block.
+struct MorphPath
+{
+    static constexpr int maxStates = 8;
+
+    struct State
+    {
+        double centerFrequency = 0.0;
+        double spread = 0.0;
+        double panOne = 0.0;
+        double panTwo = 0.0;
+        double driveDb = 0.0;
+        double typeMix = 0.0;
+
+        // Linear gains: the overall tone gain, and each tone's with its attenuation folded in
+        double toneGain = 0.0;
+        double gainOne = 0.0;
+        double gainTwo = 0.0;
+
+        WaveshaperTable shaper;
+    };
+
+    // The stretch between states[index] and states[index + 1], and how far along it a position lies.
+    struct Segment
+    {
+        int index = 0;
+        double weight = 0.0;
+    };
+
+    // Shaper tables for one render chunk. With two tables each sample crossfades from the first
+    // to the second, with weight moving linearly from weightStart to weightEnd over the chunk.
+    struct Shaping
+    {
+        const WaveshaperTable* from = nullptr;
+        const WaveshaperTable* to = nullptr;
+        double weightStart = 0.0;
+        double weightEnd = 0.0;
+    };
+
+    // Builds the path from at most maxStates states. baseToneGainDb is the tone level at 0 dB gain.
+    void build(const std::vector<PluginState>& stateList, double baseToneGainDb);
+
+    // A path needs two states; anything less leaves the tone controls in charge.
+    bool isActive() const noexcept { return states.size() >= 2; }
+
+    // Only valid for an active path. Positions outside [0, 1] are clamped.
+    Segment locate(double position) const noexcept;
+
+    // Shaping from startPosition to endPosition, which must lie within one segment or on its ends.
+    // The second table is left out when the two states share a curve or the chunk sits on a state.
+    Shaping getShaping(double startPosition, double endPosition) const noexcept;
+
+    // The first state, or the target if it comes first, that a move from one position to another reaches.
+    double getNextStatePosition(double from, double to) const noexcept;
+
+    // Harmonics below Nyquist for a tone at this frequency, for the state with the most of them.
+    int getNumHarmonicsBelow(double frequency, double sampleRate) const noexcept;
+
+    std::vector<State> states;
+
+    // Bumped by the publisher so the audio thread can tell a new path from the last one.
+    std::uint32_t revision = 0;
+};
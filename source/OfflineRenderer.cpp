@@ -0,0 +1,126 @@
+#include "OfflineRenderer.h"
+
+#include "DualToneEngine.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace
+{
+// One engine and chunk buffer per pool thread; renders whichever chunk it is given next.
+class ChunkJob : public juce::ThreadPoolJob
+{
+public:
+    ChunkJob(const OfflineRenderer::Options& renderOptions, const PluginState& state)
+        : juce::ThreadPoolJob("Offline render chunk"),
+          options(renderOptions),
+          chunk(renderOptions.numChannels, renderOptions.chunkLength)
+    {
+        DualToneEngine::ParameterValues pointers;
+
+        for (size_t index = 0; index < values.size(); ++index)
+        {
+            values[index].store(PluginState::parameterRanges[index].constrain(state.values[index]));
+            pointers[index] = &values[index];
+        }
+
+        // Non-realtime, so shaper tables are built inline and no worker is needed
+        engine.setParameterValues(pointers);
+        engine.setNonRealtime(true);
+        engine.setChannelLayout(juce::AudioChannelSet::canonicalChannelSet(options.numChannels));
+        engine.setToneBank(state.toneBank);
+    }
+
+    void setChunk(juce::int64 chunkStart, int chunkLength) noexcept
+    {
+        start = chunkStart;
+        length = chunkLength;
+    }
+
+    const juce::AudioBuffer<float>& getChunk() const noexcept { return chunk; }
+    int getLength() const noexcept { return length; }
+
+    JobStatus runJob() override
+    {
+        // Preparing again resets every ramp and filter, so the chunk does not depend on the one before it
+        engine.prepare(options.sampleRate);
+        engine.seekTo(start);
+
+        for (int done = 0; done < length; done += options.blockSize)
+        {
+            const auto count = juce::jmin(options.blockSize, length - done);
+            juce::AudioBuffer<float> block(chunk.getArrayOfWritePointers(), options.numChannels, done, count);
+            engine.process(block, midi);
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    const OfflineRenderer::Options& options;
+    std::array<std::atomic<float>, PluginState::numParameters> values;
+    DualToneEngine engine;
+    juce::AudioBuffer<float> chunk;
+    const juce::MidiBuffer midi;
+    juce::int64 start = 0;
+    int length = 0;
+};
+} // namespace
+
+PluginState OfflineRenderer::getDefaultState() noexcept
+{
+    PluginState state;
+
+    for (size_t index = 0; index < state.values.size(); ++index)
+        state.values[index] = PluginState::parameterRanges[index].defaultValue;
+
+    return state;
+}
+
+bool OfflineRenderer::render(const Options& options, const PluginState& state, const ChunkSink& sink)
+{
+    if (options.sampleRate <= 0.0 || options.numChannels < 1 || options.lengthInSamples < 0
+        || options.chunkLength < 1 || options.blockSize < 1 || options.numThreads < 1)
+        return false;
+
+    std::vector<std::unique_ptr<ChunkJob>> jobs;
+
+    for (int thread = 0; thread < options.numThreads; ++thread)
+        jobs.push_back(std::make_unique<ChunkJob>(options, state));
+
+    juce::ThreadPool pool(options.numThreads);
+    auto sinkAccepted = true;
+
+    // One chunk per thread at a time. The sink writes each chunk as soon as it and all earlier ones
+    // are done, while the later chunks of the round are still rendering.
+    for (juce::int64 roundStart = 0; roundStart < options.lengthInSamples && sinkAccepted;)
+    {
+        auto numActive = 0;
+
+        for (auto& job : jobs)
+        {
+            if (roundStart >= options.lengthInSamples)
+                break;
+
+            const auto length = static_cast<int>(juce::jmin(static_cast<juce::int64>(options.chunkLength),
+                                                            options.lengthInSamples - roundStart));
+            job->setChunk(roundStart, length);
+            pool.addJob(job.get(), false);
+            roundStart += length;
+            ++numActive;
+        }
+
+        for (int index = 0; index < numActive; ++index)
+        {
+            auto& job = jobs[static_cast<std::size_t>(index)];
+            pool.waitForJobToFinish(job.get(), -1);
+
+            if (sinkAccepted)
+                sinkAccepted = sink(job->getChunk(), job->getLength());
+        }
+    }
+
+    return sinkAccepted;
+}
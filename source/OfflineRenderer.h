@@ -0,0 +1,42 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <functional>
+
+#include "PluginState.h"
+
+// Renders a long stretch of the engine's output faster than real time.
+//
+// The timeline is cut into fixed-length chunks. Each chunk is rendered by its own engine
+// instance, which is seeked to the chunk's first sample, so its starting phases come from
+// the sample position rather than from the chunk before it. Chunks therefore render in
+// parallel on a thread pool, yet every chunk's samples depend only on its position: the
+// output is bit-identical whatever the thread count, including a single thread. Finished
+// chunks are handed to the sink strictly in timeline order.
+//
+// Everything runs on DualToneEngine directly, with no processor, message manager or GUI.
+class OfflineRenderer
+{
+public:
+    struct Options
+    {
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        juce::int64 lengthInSamples = 0;
+        int chunkLength = 1 << 16;
+        int blockSize = 4096;
+        int numThreads = 1;
+    };
+
+    // Receives the next chunk in timeline order; numSamples may be shorter than the buffer for the last chunk.
+    // Returning false stops the render.
+    using ChunkSink = std::function<bool(const juce::AudioBuffer<float>& chunk, int numSamples)>;
+
+    // Renders with the state's parameter values, constrained to their ranges, and its tone bank.
+    // Returns false if the options are invalid or the sink stopped the render.
+    static bool render(const Options& options, const PluginState& state, const ChunkSink& sink);
+
+    // The state every parameter starts from, with no tone bank.
+    static PluginState getDefaultState() noexcept;
+};
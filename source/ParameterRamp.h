@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cmath>
+
+// Linear ramp from a parameter's current value to its latest target.
+//
+// Works like juce::SmoothedValue in linear mode, but also reports how many samples are left
+// in the ramp. The processor uses that to end a render chunk exactly where a ramp ends, so
+// the interpolated values do not depend on how the host splits its blocks.
+class ParameterRamp
+{
+public:
+    // Sets the ramp length and jumps straight to the current target.
+    void reset(double sampleRate, double rampSeconds) noexcept
+    {
+        rampLength = static_cast<int>(std::floor(rampSeconds * sampleRate));
+        current = target;
+        remaining = 0;
+    }
+
+    void setTarget(double newTarget) noexcept
+    {
+        if (newTarget == target)
+            return;
+
+        target = newTarget;
+
+        if (rampLength <= 0)
+        {
+            current = target;
+            remaining = 0;
+            return;
+        }
+
+        step = (target - current) / static_cast<double>(rampLength);
+        remaining = rampLength;
+    }
+
+    bool isRamping() const noexcept { return remaining > 0; }
+    int getRemainingSamples() const noexcept { return remaining; }
+
+    double getCurrent() const noexcept { return current; }
+    double getTarget() const noexcept { return target; }
+
+    void advance(int numSamples) noexcept
+    {
+        if (numSamples >= remaining)
+        {
+            current = target;
+            remaining = 0;
+            return;
+        }
+
+        current += step * static_cast<double>(numSamples);
+        remaining -= numSamples;
+    }
+
+private:
+    double current = 0.0;
+    double target = 0.0;
+    double step = 0.0;
+    int rampLength = 0;
+    int remaining = 0;
+};
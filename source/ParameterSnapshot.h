@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "PluginState.h"
+
+// Coherent view of every parameter for the audio thread.
+//
+// The values themselves stay in the value tree's atomics, which the host and the editor write
+// one at a time. Code that changes several of them together does so inside a ScopedBatch. The
+// audio thread takes a snapshot once per block by copying every value, and keeps the snapshot
+// it already has if a batch was open, or opened, while it copied. It never waits, and it never
+// sees half of a batch.
+//
+// The version moves on whenever a value differs from the previous snapshot, so whatever the
+// audio thread derives from the values only needs working out again when the version changes.
+//
+// The audio thread can also override the values itself, e.g. for a preset it switched to, so it
+// never writes the sources. An overridden value stands until its source moves, e.g. because the
+// host or the editor wrote a newer one, or until the thread that brings the sources up to date
+// releases the override.
+class ParameterSnapshot
+{
+public:
+    using Values = std::array<float, PluginState::numParameters>;
+    using Sources = std::array<const std::atomic<float>*, PluginState::numParameters>;
+
+    // Takes the first snapshot straight away. The sources must outlive the snapshot.
+    void setSources(const Sources& newSources) noexcept
+    {
+        sources = newSources;
+
+        for (size_t index = 0; index < values.size(); ++index)
+            values[index] = sources[index]->load();
+
+        overridden.fill(false);
+        ++version;
+    }
+
+    //==============================================================================
+    // Audio thread
+
+    // Returns true if the values changed since the last snapshot.
+    bool update() noexcept
+    {
+        // Read first, so the sources read below include everything written before the release
+        const auto released = releasedGeneration.load();
+        const auto changesBefore = changeCount.load();
+
+        if (openBatches.load() > 0)
+            return false;
+
+        Values latest;
+
+        for (size_t index = 0; index < latest.size(); ++index)
+            latest[index] = sources[index]->load();
+
+        if (changeCount.load() != changesBefore)
+            return false;
+
+        if (released == overrideGeneration.load(std::memory_order_relaxed))
+            overridden.fill(false);
+
+        for (size_t index = 0; index < latest.size(); ++index)
+        {
+            if (! overridden[index])
+                continue;
+
+            if (latest[index] != overriddenSources[index])
+                overridden[index] = false;
+            else
+                latest[index] = values[index];
+        }
+
+        if (latest == values)
+            return false;
+
+        values = latest;
+        ++version;
+        return true;
+    }
+
+    // Takes these values straight away, ahead of the sources; see the class description.
+    void overrideValues(const Values& newValues) noexcept
+    {
+        overrideGeneration.fetch_add(1);
+
+        for (size_t index = 0; index < values.size(); ++index)
+        {
+            if (! overridden[index])
+            {
+                overriddenSources[index] = sources[index]->load();
+                overridden[index] = true;
+            }
+
+            values[index] = newValues[index];
+        }
+
+        ++version;
+    }
+
+    float operator[](PluginState::Parameter parameter) const noexcept { return values[static_cast<size_t>(parameter)]; }
+    const Values& getValues() const noexcept { return values; }
+    std::uint32_t getVersion() const noexcept { return version; }
+
+    //==============================================================================
+    // Any thread
+
+    // Counts overrides. Once the sources hold the values of every override up to a generation,
+    // releasing it lets the sources through again; an override made since stands.
+    std::uint32_t getOverrideGeneration() const noexcept { return overrideGeneration.load(); }
+    void releaseOverride(std::uint32_t generation) noexcept { releasedGeneration.store(generation); }
+
+    // Holds the audio thread at its current snapshot while in scope, so every change made meanwhile
+    // reaches it in the same block. Batches may nest and may be open on several threads at once.
+    class ScopedBatch
+    {
+    public:
+        explicit ScopedBatch(ParameterSnapshot& snapshotToHold) noexcept : snapshot(snapshotToHold)
+        {
+            snapshot.openBatches.fetch_add(1);
+            snapshot.changeCount.fetch_add(1);
+        }
+
+        ~ScopedBatch()
+        {
+            snapshot.changeCount.fetch_add(1);
+            snapshot.openBatches.fetch_sub(1);
+        }
+
+        ScopedBatch(const ScopedBatch&) = delete;
+        ScopedBatch& operator=(const ScopedBatch&) = delete;
+
+    private:
+        ParameterSnapshot& snapshot;
+    };
+
+private:
+    Sources sources {};
+    Values values {};
+    std::uint32_t version = 0;
+
+    // Audio thread: the source values at the time each value was overridden
+    std::array<bool, PluginState::numParameters> overridden {};
+    Values overriddenSources {};
+
+    std::atomic<int> openBatches { 0 };
+    std::atomic<std::uint32_t> changeCount { 0 };
+    std::atomic<std::uint32_t> overrideGeneration { 0 };
+    std::atomic<std::uint32_t> releasedGeneration { 0 };
+};
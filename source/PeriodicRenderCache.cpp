@@ -0,0 +1,180 @@
+#include "PeriodicRenderCache.h"
+
+#include "SineOscillator.h"
+
+#include <iterator>
+
+namespace
+{
+constexpr int idlePollIntervalMs = 20;
+
+// Settings have to stay put for this many polls, about a quarter of a second, before a period is
+// rendered, so a knob being turned slowly does not keep the worker rendering periods that are never
+// played. Counting polls rather than wall-clock time lets a caller without a worker drive it directly.
+constexpr int settlePolls = 250 / idlePollIntervalMs;
+
+constexpr int renderChunkSize = 256;
+} // namespace
+
+bool PeriodicRenderSettings::operator==(const PeriodicRenderSettings& other) const noexcept
+{
+    if (sampleRate != other.sampleRate
+        || incrementOne != other.incrementOne
+        || incrementTwo != other.incrementTwo
+        || driveDb != other.driveDb
+        || shapeType != other.shapeType
+        || harmonicShaping != other.harmonicShaping
+        || harmonicsOne != other.harmonicsOne
+        || harmonicsTwo != other.harmonicsTwo
+        || numChannels != other.numChannels)
+        return false;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        if (gainsOne[channel] != other.gainsOne[channel] || gainsTwo[channel] != other.gainsTwo[channel])
+            return false;
+
+    return true;
+}
+
+void PeriodicRenderCache::submit(const PeriodicRenderSettings& settings,
+                                 FixedPhase::Value phaseOne,
+                                 FixedPhase::Value phaseTwo,
+                                 std::uint64_t clock) noexcept
+{
+    if (submissionValid && settings == submittedSettings)
+        return;
+
+    submittedSettings = settings;
+    submissionValid = true;
+
+    // Zero is the revision of a slot that has never been rendered
+    if (++submittedRevision == 0)
+        ++submittedRevision;
+
+    auto& request = requests.beginUpdate();
+    request.settings = settings;
+    request.revision = submittedRevision;
+    request.referenceClock = clock;
+    request.phaseOne = phaseOne;
+    request.phaseTwo = phaseTwo;
+    requests.publish();
+}
+
+const PeriodicRender* PeriodicRenderCache::acquire() noexcept
+{
+    if (auto* render = renders.pin())
+    {
+        if (submissionValid && render->revision == submittedRevision && render->toneOne.length > 0)
+            return render;
+
+        renders.unpin();
+    }
+
+    return nullptr;
+}
+
+void PeriodicRenderCache::release() noexcept
+{
+    renders.unpin();
+}
+
+int PeriodicRenderCache::findPeriod(FixedPhase::Value step, int maxLength) noexcept
+{
+    // The accumulated phase is exact, so the loop error is just its distance from a whole cycle
+    const auto tolerance = static_cast<FixedPhase::Value>(maxPhaseError * FixedPhase::fullScale);
+    FixedPhase::Value phase = 0;
+
+    for (int length = 1; length <= maxLength; ++length)
+    {
+        phase += step;
+
+        if (std::min(phase, 0 - phase) <= tolerance)
+            return length;
+    }
+
+    return 0;
+}
+
+int PeriodicRenderCache::useTimeSlice()
+{
+    // Superseded periods are freed once playback has moved off them rather than kept for reuse
+    renders.forEachSpareSlot([](PeriodicRender& spare) {
+        spare = {};
+    });
+
+    const auto* request = requests.pin();
+
+    if (request == nullptr)
+    {
+        requests.unpin();
+        return idlePollIntervalMs;
+    }
+
+    latestRequest = *request;
+    requests.unpin();
+
+    if (latestRequest.revision != seenRevision)
+    {
+        seenRevision = latestRequest.revision;
+        pollsSinceSeen = 0;
+        return idlePollIntervalMs;
+    }
+
+    if (latestRequest.revision == handledRevision || ++pollsSinceSeen < settlePolls)
+        return idlePollIntervalMs;
+
+    handledRevision = latestRequest.revision;
+
+    const auto& settings = latestRequest.settings;
+    const auto lengthOne = findPeriod(FixedPhase::fromRadians(settings.incrementOne), maxPeriodLength);
+    const auto lengthTwo = findPeriod(FixedPhase::fromRadians(settings.incrementTwo), maxPeriodLength);
+
+    if (lengthOne == 0 || lengthTwo == 0)
+        return idlePollIntervalMs;
+
+    if (! table.matches(settings.driveDb, settings.shapeType))
+        table.build(WaveshaperCurve::fromParameters(settings.driveDb, settings.shapeType));
+
+    auto& render = renders.beginUpdate();
+    render.revision = latestRequest.revision;
+    render.numChannels = settings.numChannels;
+    render.referenceClock = latestRequest.referenceClock;
+    std::copy(std::begin(settings.gainsOne), std::end(settings.gainsOne), std::begin(render.gainsOne));
+    std::copy(std::begin(settings.gainsTwo), std::end(settings.gainsTwo), std::begin(render.gainsTwo));
+    renderTone(settings, settings.incrementOne, latestRequest.phaseOne, settings.harmonicsOne, lengthOne, render.toneOne);
+    renderTone(settings, settings.incrementTwo, latestRequest.phaseTwo, settings.harmonicsTwo, lengthTwo, render.toneTwo);
+    renders.publish();
+
+    return idlePollIntervalMs;
+}
+
+void PeriodicRenderCache::renderTone(const PeriodicRenderSettings& settings,
+                                     double increment,
+                                     FixedPhase::Value phase,
+                                     int harmonics,
+                                     int length,
+                                     PeriodicTone& tone)
+{
+    SineOscillator oscillator;
+    oscillator.setPhaseIncrement(increment);
+    oscillator.setFixedPhase(phase);
+
+    tone.length = length;
+    tone.phase = phase;
+    tone.step = oscillator.getFixedStep();
+    tone.samples.resize(static_cast<std::size_t>(length));
+
+    // The same oscillator and shaper kernels the audio thread runs for a block-constant chunk
+    for (int start = 0; start < length; start += renderChunkSize)
+    {
+        const auto count = juce::jmin(renderChunkSize, length - start);
+        auto* wave = tone.samples.data() + start;
+
+        oscillator.render(wave, count);
+
+        if (settings.harmonicShaping)
+            table.getHarmonics().render(wave, wave, count, harmonics);
+        else
+            table.process(wave, wave, count);
+    }
+}
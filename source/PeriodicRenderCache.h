@@ -0,0 +1,190 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "ChannelPanner.h"
+#include "FixedPhase.h"
+#include "RealtimeResourceSlots.h"
+#include "ToneKernels.h"
+#include "WaveshaperTable.h"
+
+// Everything that determines the shaped, panned output of the Center/Spread tone pair while
+// no parameter is moving. Two equal settings produce the same periodic signal.
+struct PeriodicRenderSettings
+{
+    double sampleRate = 0.0;
+    double incrementOne = 0.0;
+    double incrementTwo = 0.0;
+    float driveDb = 0.0f;
+    float shapeType = 0.0f;
+    bool harmonicShaping = false;
+    int harmonicsOne = 0;
+    int harmonicsTwo = 0;
+    int numChannels = 0;
+
+    // Tone gain, attenuation and pan folded into one gain per tone and channel.
+    double gainsOne[ChannelPanner::maxChannels] {};
+    double gainsTwo[ChannelPanner::maxChannels] {};
+
+    bool operator==(const PeriodicRenderSettings& other) const noexcept;
+    bool operator!=(const PeriodicRenderSettings& other) const noexcept { return ! (*this == other); }
+};
+
+// Settings plus the oscillator phases at a point on the processor's sample clock.
+struct PeriodicRenderRequest
+{
+    PeriodicRenderSettings settings;
+    std::uint32_t revision = 0;
+    std::uint64_t referenceClock = 0;
+    FixedPhase::Value phaseOne = 0;
+    FixedPhase::Value phaseTwo = 0;
+};
+
+// One shaped tone over a whole number of its cycles, starting at the render's reference clock.
+struct PeriodicTone
+{
+    int length = 0;
+    FixedPhase::Value phase = 0;
+    FixedPhase::Value step = 0;
+    std::vector<double> samples;
+
+    int getPosition(std::uint64_t elapsed) const noexcept
+    {
+        return static_cast<int>(elapsed % static_cast<std::uint64_t>(length));
+    }
+
+    // Oscillator phase that continues the rendered tone from this position.
+    FixedPhase::Value getPhase(int position) const noexcept
+    {
+        return FixedPhase::advance(phase, step, static_cast<std::uint64_t>(position));
+    }
+};
+
+// Both tones' periods and the gains that mix them into each channel.
+struct PeriodicRender
+{
+    std::uint32_t revision = 0;
+    int numChannels = 0;
+    std::uint64_t referenceClock = 0;
+    double gainsOne[ChannelPanner::maxChannels] {};
+    double gainsTwo[ChannelPanner::maxChannels] {};
+    PeriodicTone toneOne;
+    PeriodicTone toneTwo;
+
+    // Oscillator phases that continue the rendered signal from the sample clock.
+    FixedPhase::Value getPhaseOne(std::uint64_t clock) const noexcept
+    {
+        return toneOne.getPhase(toneOne.getPosition(clock - referenceClock));
+    }
+
+    FixedPhase::Value getPhaseTwo(std::uint64_t clock) const noexcept
+    {
+        return toneTwo.getPhase(toneTwo.getPosition(clock - referenceClock));
+    }
+
+    // Mixes numSamples starting at the sample clock into the first numOutputs outputs.
+    template <typename SampleType>
+    void play(SampleType* const* outputs, int numOutputs, std::uint64_t clock, int numSamples) const noexcept
+    {
+        const auto startOne = toneOne.getPosition(clock - referenceClock);
+        const auto startTwo = toneTwo.getPosition(clock - referenceClock);
+
+        for (int channel = 0; channel < numOutputs; ++channel)
+        {
+            auto* output = outputs[channel];
+            auto positionOne = startOne;
+            auto positionTwo = startTwo;
+
+            // Each run ends where the first of the two periods wraps
+            for (int done = 0; done < numSamples;)
+            {
+                const auto count = std::min({ numSamples - done, toneOne.length - positionOne, toneTwo.length - positionTwo });
+                ToneKernels::mixTonesToChannel<SampleType, false>(toneOne.samples.data() + positionOne,
+                                                                  toneTwo.samples.data() + positionTwo,
+                                                                  gainsOne[channel],
+                                                                  gainsTwo[channel],
+                                                                  output + done,
+                                                                  count);
+                done += count;
+                positionOne = positionOne + count < toneOne.length ? positionOne + count : 0;
+                positionTwo = positionTwo + count < toneTwo.length ? positionTwo + count : 0;
+            }
+        }
+    }
+};
+
+// Renders the tone pair's shaped tones once their settings have been still for a while.
+//
+// With nothing ramping, each shaped tone is periodic and only the pan gains mix the two. The
+// worker searches each tone for the shortest length after which its phase comes back within
+// maxPhaseError, renders that many samples through the same oscillator and shaper as the
+// audio thread would, and publishes both periods. The audio thread then mixes the block from
+// the periods instead of synthesising, and sets the oscillator phases from the playback
+// positions, so live synthesis picks up seamlessly as soon as any setting changes. Looping
+// the tones separately rather than their common period is what lets any frequency pair cache:
+// a single tone always comes back within the tolerance inside maxPeriodLength samples.
+class PeriodicRenderCache : public juce::TimeSliceClient
+{
+public:
+    PeriodicRenderCache() = default;
+
+    // Audio thread: records the settings for this block. Phases and clock only matter when the
+    // settings differ from the previous call, because the live phases then start a new reference.
+    void submit(const PeriodicRenderSettings& settings,
+                FixedPhase::Value phaseOne,
+                FixedPhase::Value phaseTwo,
+                std::uint64_t clock) noexcept;
+
+    // Audio thread: the oscillators no longer follow the last submission, e.g. after a block that
+    // could not be cached. The next submit() starts a new reference even with equal settings.
+    void invalidate() noexcept { submissionValid = false; }
+
+    // Audio thread: returns the period for the last submission or nullptr. Call release() once the block is done.
+    const PeriodicRender* acquire() noexcept;
+    void release() noexcept;
+
+    int useTimeSlice() override;
+
+    // Shortest length in samples after which the fixed-point step completes whole cycles to
+    // within maxPhaseError cycles, or 0 if there is none up to maxLength.
+    static int findPeriod(FixedPhase::Value step, int maxLength) noexcept;
+
+    // Phase error accepted at the loop point, in cycles. The step it leaves in the waveform is
+    // at most 2 pi times that, about 6e-5 of the tone's level or -84 dB, and each pass through
+    // the loop detunes the tone by the same fraction of a cycle, under 0.02 cent for a loop of
+    // even a single cycle.
+    static constexpr double maxPhaseError = 1.0e-5;
+
+    // Upper bound on a tone's period. Any step has a period within 1 / maxPhaseError samples,
+    // so every setting caches. A rendered pair holds at most 2 MiB, and the worker empties the
+    // slots that are neither published nor playing.
+    static constexpr int maxPeriodLength = 1 << 17;
+
+private:
+    void renderTone(const PeriodicRenderSettings& settings,
+                    double increment,
+                    FixedPhase::Value phase,
+                    int harmonics,
+                    int length,
+                    PeriodicTone& tone);
+
+    // Audio thread
+    RealtimeResourceSlots<PeriodicRenderRequest> requests;
+    PeriodicRenderSettings submittedSettings;
+    std::uint32_t submittedRevision = 0;
+    bool submissionValid = false;
+
+    // Worker thread
+    RealtimeResourceSlots<PeriodicRender> renders;
+    PeriodicRenderRequest latestRequest;
+    std::uint32_t seenRevision = 0;
+    std::uint32_t handledRevision = 0;
+    int pollsSinceSeen = 0;
+    WaveshaperTable table;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PeriodicRenderCache)
+};
@@ -1,12 +1,11 @@
 #include "PluginEditor.h"
 #include "PluginProcessor.h"
-#include "BinaryData.h"
 
 namespace
 {
 constexpr int defaultEditorWidth = 720;
 constexpr int defaultEditorHeight = 540;
-constexpr int extraBottomPadding = 40;
+constexpr int extraBottomPadding = 72;
 constexpr float minEditorScale = 0.5f;
 constexpr float maxEditorScale = 2.0f;
 
@@ -16,7 +15,7 @@ const juce::Colour backgroundBottomColour = backgroundMidColour.darker(0.4f);
 const juce::Colour outerFrameColour { 18, 15, 13 };
 const juce::Colour panelBaseColour { 228, 214, 202 };
 const juce::Colour labelActiveColour { 73, 56, 44 };
-const juce::Colour labelInactiveColour = labelActiveColour.withMultipliedAlpha(0.35f);
+constexpr float inactiveLabelAlpha = 0.35f;
 const juce::Colour toneAccentColour = labelActiveColour.darker(0.6f);
 const juce::Colour dialOutlineColour { 116, 96, 80 };
 const juce::Colour largeDialTrackColour { 196, 72, 62 };
@@ -55,24 +54,20 @@ DualToneGeneratorAudioProcessorEditor::DualToneGeneratorAudioProcessorEditor(Dua
       gainAttachment(processorRef.getValueTreeState(), "gain", gainSlider),
       driveAttachment(processorRef.getValueTreeState(), "drive", driveSlider),
       typeAttachment(processorRef.getValueTreeState(), "shapeType", typeSlider),
-      largeDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(BinaryData::cog_knob_large_svg,
-                                                                BinaryData::cog_knob_large_svgSize,
+      scopeView(processorRef.getScopeFifo(), labelActiveColour, panelBaseColour.darker(0.08f)),
+      largeDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(assets->getKnobAtlas(EditorAssets::knobLarge),
                                                                 largeDialTrackColour,
                                                                 dialOutlineColour)),
-      greenDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(BinaryData::cog_knob_green_svg,
-                                                                BinaryData::cog_knob_green_svgSize,
+      greenDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(assets->getKnobAtlas(EditorAssets::knobGreen),
                                                                 greenTrackColour,
                                                                dialOutlineColour)),
-      blueDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(BinaryData::cog_knob_blue_svg,
-                                                               BinaryData::cog_knob_blue_svgSize,
+      blueDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(assets->getKnobAtlas(EditorAssets::knobBlue),
                                                                blueTrackColour,
                                                                dialOutlineColour)),
-      grayDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(BinaryData::cog_knob_gray_svg,
-                                                               BinaryData::cog_knob_gray_svgSize,
+      grayDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(assets->getKnobAtlas(EditorAssets::knobGray),
                                                                grayTrackColour,
                                                                dialOutlineColour)),
-      darkDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(BinaryData::cog_knob_dark_svg,
-                                                               BinaryData::cog_knob_dark_svgSize,
+      darkDialLookAndFeel(std::make_unique<SvgDialLookAndFeel>(assets->getKnobAtlas(EditorAssets::knobDark),
                                                                darkTrackColour,
                                                                dialOutlineColour))
 {
@@ -146,11 +141,9 @@ DualToneGeneratorAudioProcessorEditor::DualToneGeneratorAudioProcessorEditor(Dua
         return text.trimCharactersAtEnd("%").getDoubleValue() * 0.01;
     };
 
-    logoDrawable = juce::Drawable::createFromImageData(BinaryData::logo_svg,
-                                                       BinaryData::logo_svgSize);
+    logoDrawable = assets->getDrawable(EditorAssets::logo);
     if (includeDualVcoGraphic)
-        dualVcoDrawable = juce::Drawable::createFromImageData(BinaryData::vco_circuit_svg,
-                                                              BinaryData::vco_circuit_svgSize);
+        dualVcoDrawable = assets->getDrawable(EditorAssets::vcoCircuit);
 
     auto initStaticLabel = [this](juce::Label& label,
                                   const juce::String& text,
@@ -189,6 +182,14 @@ DualToneGeneratorAudioProcessorEditor::DualToneGeneratorAudioProcessorEditor(Dua
     initStaticLabel(centerMaxLabel, "600", 18.0f, false, labelActiveColour.withMultipliedAlpha(0.55f));
     initStaticLabel(spreadMinLabel, "0", 18.0f, false, labelActiveColour.withMultipliedAlpha(0.55f));
     initStaticLabel(spreadMaxLabel, "40", 18.0f, false, labelActiveColour.withMultipliedAlpha(0.55f));
+    initStaticLabel(loadLabel, {}, 11.0f, false, labelActiveColour.withMultipliedAlpha(0.55f));
+    loadLabel.setMinimumHorizontalScale(1.0f);
+
+    addAndMakeVisible(scopeView);
+
+    // The static labels keep their layout but are painted as part of the cached background
+    for (auto* label : getStaticLabels())
+        label->setPaintedByEditor(true);
 
     const auto minWidth = juce::roundToInt(static_cast<float>(defaultEditorWidth) * minEditorScale);
     const auto minHeight = juce::roundToInt(static_cast<float>(defaultEditorHeight) * minEditorScale) + extraBottomPadding;
@@ -214,7 +215,52 @@ DualToneGeneratorAudioProcessorEditor::~DualToneGeneratorAudioProcessorEditor()
         slider->setLookAndFeel(nullptr);
 }
 
+void DualToneGeneratorAudioProcessorEditor::setStaticLayerCachingEnabled(bool shouldCache)
+{
+    cacheStaticLayer = shouldCache;
+    staticLayer = {};
+
+    for (auto* label : getStaticLabels())
+        label->setPaintedByEditor(shouldCache);
+
+    repaint();
+}
+
+juce::Array<DualToneGeneratorAudioProcessorEditor::StaticLabel*> DualToneGeneratorAudioProcessorEditor::getStaticLabels()
+{
+    return { &gainMinLabel, &gainMaxLabel, &toneOneTitleLabel, &toneTwoTitleLabel, &centerLabel, &spreadLabel,
+             &panOneLabel, &panTwoLabel, &attenuationOneLabel, &attenuationTwoLabel, &gainLabel, &driveLabel,
+             &typeLabel, &typeMinLabel, &typeMaxLabel, &centerUnitLabel, &spreadUnitLabel, &centerMinLabel,
+             &centerMaxLabel, &spreadMinLabel, &spreadMaxLabel };
+}
+
 void DualToneGeneratorAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    if (! cacheStaticLayer)
+    {
+        paintStaticLayer(g, false);
+        return;
+    }
+
+    const auto pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (staticLayer.isNull() || staticLayerPixelScale != pixelScale)
+    {
+        staticLayer = juce::Image(juce::Image::RGB,
+                                  juce::jmax(1, juce::roundToInt(static_cast<float>(getWidth()) * pixelScale)),
+                                  juce::jmax(1, juce::roundToInt(static_cast<float>(getHeight()) * pixelScale)),
+                                  false);
+        staticLayerPixelScale = pixelScale;
+
+        juce::Graphics layerGraphics(staticLayer);
+        layerGraphics.addTransform(juce::AffineTransform::scale(pixelScale));
+        paintStaticLayer(layerGraphics, true);
+    }
+
+    g.drawImageTransformed(staticLayer, juce::AffineTransform::scale(1.0f / pixelScale));
+}
+
+void DualToneGeneratorAudioProcessorEditor::paintStaticLayer(juce::Graphics& g, bool includeLabels)
 {
     const auto fullBounds = getLocalBounds().toFloat();
 
@@ -276,6 +322,16 @@ void DualToneGeneratorAudioProcessorEditor::paint(juce::Graphics& g)
 
     drawDividerGroove(toneOneDividerLine);
     drawDividerGroove(toneTwoDividerLine);
+
+    if (includeLabels)
+    {
+        for (auto* label : getStaticLabels())
+        {
+            juce::Graphics::ScopedSaveState state(g);
+            g.setOrigin(label->getPosition());
+            label->getLookAndFeel().drawLabel(g, *label);
+        }
+    }
 }
 
 void DualToneGeneratorAudioProcessorEditor::resized()
@@ -382,6 +438,21 @@ void DualToneGeneratorAudioProcessorEditor::resized()
         }
     }
 
+    // The DSP load readout sits between the large dials under the logo, below the Dual VCO graphic if it is shown
+    if (!dualVcoBounds.isEmpty())
+    {
+        const auto loadWidth = juce::roundToInt(90.0f * scale);
+        const auto loadHeight = juce::roundToInt(42.0f * scale);
+        const auto loadCentreY = includeDualVcoGraphic ? dualVcoBounds.getBottom() + loadHeight / 2
+                                                       : dualVcoBounds.getCentreY();
+        loadLabel.setBounds(juce::Rectangle<int>(loadWidth, loadHeight)
+                                .withCentre({ dualVcoBounds.getCentreX(), loadCentreY }));
+    }
+    else
+    {
+        loadLabel.setBounds({});
+    }
+
     const auto toneBlockGap = juce::roundToInt(72.0f * scale);
     auto toneOneArea = bottomArea.removeFromLeft((bottomArea.getWidth() - toneBlockGap) / 2);
     bottomArea.removeFromLeft(toneBlockGap);
@@ -454,18 +525,71 @@ void DualToneGeneratorAudioProcessorEditor::resized()
 
     toneOneDividerLine = computeToneDivider(panOneSlider, attenuationOneSlider, toneOneTitleLabel, scale);
     toneTwoDividerLine = computeToneDivider(panTwoSlider, attenuationTwoSlider, toneTwoTitleLabel, scale);
+    staticLayer = {};
+
+    // Scope and spectrum share the bottom strip under the tone sections, either side of the Type dial
+    auto scopeStrip = rootBounds.withTop(layoutBounds.getBottom())
+                          .withTrimmedLeft(contentPanelBounds.getX() - rootBounds.getX())
+                          .withTrimmedRight(rootBounds.getRight() - contentPanelBounds.getRight())
+                          .reduced(0, juce::roundToInt(10.0f * scale));
+    const auto scopeGap = juce::roundToInt(12.0f * scale);
+    const auto typeDialBounds = typeSlider.getBounds().getUnion(typeMinLabel.getBounds()).getUnion(typeMaxLabel.getBounds());
+    auto scopeArea = scopeStrip.withRight(juce::jmin(toneOneArea.getRight(), typeDialBounds.getX() - scopeGap));
+    auto spectrumArea = scopeStrip.withLeft(juce::jmax(toneTwoArea.getX(), typeDialBounds.getRight() + scopeGap));
+    scopeView.setBounds(scopeStrip);
+    scopeView.setPanelBounds(scopeArea - scopeStrip.getPosition(), spectrumArea - scopeStrip.getPosition());
 
 }
 
 void DualToneGeneratorAudioProcessorEditor::timerCallback()
 {
     const auto stereo = processorRef.isStereoOutput();
-    panOneSlider.setEnabled(stereo);
-    panTwoSlider.setEnabled(stereo);
+    const auto pairControls = ! processorRef.isToneBankActive();
+
+    if (stereo != stereoControlsShown || pairControls != pairControlsShown)
+    {
+        stereoControlsShown = stereo;
+        pairControlsShown = pairControls;
+
+        // A tone bank has its own offsets, levels and pans, so only Center and the shared controls act on it
+        for (auto* slider : { &spreadSlider, &attenuationOneSlider, &attenuationTwoSlider })
+            slider->setEnabled(pairControls);
+
+        panOneSlider.setEnabled(stereo && pairControls);
+        panTwoSlider.setEnabled(stereo && pairControls);
+
+        // The labels are part of the static layer
+        auto setLabelActive = [](juce::Label& label, juce::Colour activeColour, bool active)
+        {
+            label.setColour(juce::Label::textColourId, active ? activeColour : activeColour.withMultipliedAlpha(inactiveLabelAlpha));
+        };
+
+        setLabelActive(spreadLabel, toneAccentColour.darker(0.05f), pairControls);
+        setLabelActive(attenuationOneLabel, labelActiveColour, pairControls);
+        setLabelActive(attenuationTwoLabel, labelActiveColour, pairControls);
+        setLabelActive(panOneLabel, labelActiveColour, stereo && pairControls);
+        setLabelActive(panTwoLabel, labelActiveColour, stereo && pairControls);
+        staticLayer = {};
+        repaint();
+    }
+
+    const auto load = processorRef.getLoadMeter().getStats();
+
+    if (load.numBlocks == 0)
+    {
+        loadLabel.setText({}, juce::dontSendNotification);
+        return;
+    }
+
+    auto formatPercent = [](double percent)
+    {
+        return juce::String(percent, percent < 10.0 ? 1 : 0) + "%";
+    };
 
-    const auto panLabelColour = stereo ? labelActiveColour : labelInactiveColour;
-    panOneLabel.setColour(juce::Label::textColourId, panLabelColour);
-    panTwoLabel.setColour(juce::Label::textColourId, panLabelColour);
+    loadLabel.setText("DSP " + formatPercent(load.meanPercent)
+                          + "\np99 " + formatPercent(load.p99Percent)
+                          + "\npeak " + formatPercent(load.peakPercent),
+                      juce::dontSendNotification);
 }
 
 void DualToneGeneratorAudioProcessorEditor::configureSlider(juce::Slider& slider,
@@ -512,6 +636,7 @@ void DualToneGeneratorAudioProcessorEditor::updateScaledStyles(float scale)
     setLabelFont(centerMaxLabel, 18.0f);
     setLabelFont(spreadMinLabel, 18.0f);
     setLabelFont(spreadMaxLabel, 18.0f);
+    setLabelFont(loadLabel, 11.0f);
 }
 
 void DualToneGeneratorAudioProcessorEditor::layoutLargeDial(juce::Slider& slider,
@@ -6,6 +6,8 @@
 #include <memory>
 
 class DualToneGeneratorAudioProcessor;
+#include "EditorAssets.h"
+#include "ScopeView.h"
 #include "SvgDialLookAndFeel.h"
 
 class DualToneGeneratorAudioProcessorEditor : public juce::AudioProcessorEditor,
@@ -18,8 +20,32 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
 
+    // The gradient, logo, divider grooves and static labels are rendered into an image once per
+    // size and display scale and blitted on every paint. Turning this off paints them directly
+    // each time, as a baseline for the paint benchmark.
+    void setStaticLayerCachingEnabled(bool shouldCache);
+
 private:
+    // A label whose text can be painted into the cached static layer instead of by itself. It
+    // stays visible either way, so it keeps its place in the layout and the accessibility tree.
+    class StaticLabel : public juce::Label
+    {
+    public:
+        void setPaintedByEditor(bool shouldBePaintedByEditor) noexcept { paintedByEditor = shouldBePaintedByEditor; }
+
+        void paint(juce::Graphics& g) override
+        {
+            if (! paintedByEditor)
+                juce::Label::paint(g);
+        }
+
+    private:
+        bool paintedByEditor = false;
+    };
+
     void timerCallback() override;
+    void paintStaticLayer(juce::Graphics& g, bool includeLabels);
+    juce::Array<StaticLabel*> getStaticLabels();
     void configureSlider(juce::Slider& slider,
                          juce::Label& label,
                          const juce::String& labelText,
@@ -67,27 +93,28 @@ private:
     juce::Slider driveSlider;
     juce::Slider typeSlider;
 
-    juce::Label gainMinLabel;
-    juce::Label gainMaxLabel;
-    juce::Label toneOneTitleLabel;
-    juce::Label toneTwoTitleLabel;
-    juce::Label centerLabel;
-    juce::Label spreadLabel;
-    juce::Label panOneLabel;
-    juce::Label panTwoLabel;
-    juce::Label attenuationOneLabel;
-    juce::Label attenuationTwoLabel;
-    juce::Label gainLabel;
-    juce::Label driveLabel;
-    juce::Label typeLabel;
-    juce::Label typeMinLabel;
-    juce::Label typeMaxLabel;
-    juce::Label centerUnitLabel;
-    juce::Label spreadUnitLabel;
-    juce::Label centerMinLabel;
-    juce::Label centerMaxLabel;
-    juce::Label spreadMinLabel;
-    juce::Label spreadMaxLabel;
+    StaticLabel gainMinLabel;
+    StaticLabel gainMaxLabel;
+    StaticLabel toneOneTitleLabel;
+    StaticLabel toneTwoTitleLabel;
+    StaticLabel centerLabel;
+    StaticLabel spreadLabel;
+    StaticLabel panOneLabel;
+    StaticLabel panTwoLabel;
+    StaticLabel attenuationOneLabel;
+    StaticLabel attenuationTwoLabel;
+    StaticLabel gainLabel;
+    StaticLabel driveLabel;
+    StaticLabel typeLabel;
+    StaticLabel typeMinLabel;
+    StaticLabel typeMaxLabel;
+    StaticLabel centerUnitLabel;
+    StaticLabel spreadUnitLabel;
+    StaticLabel centerMinLabel;
+    StaticLabel centerMaxLabel;
+    StaticLabel spreadMinLabel;
+    StaticLabel spreadMaxLabel;
+    juce::Label loadLabel;
 
     juce::AudioProcessorValueTreeState::SliderAttachment centerAttachment;
     juce::AudioProcessorValueTreeState::SliderAttachment spreadAttachment;
@@ -99,13 +126,17 @@ private:
     juce::AudioProcessorValueTreeState::SliderAttachment driveAttachment;
     juce::AudioProcessorValueTreeState::SliderAttachment typeAttachment;
 
+    ScopeView scopeView;
+
+    juce::SharedResourcePointer<EditorAssets> assets;
+
     std::unique_ptr<SvgDialLookAndFeel> largeDialLookAndFeel;
     std::unique_ptr<SvgDialLookAndFeel> greenDialLookAndFeel;
     std::unique_ptr<SvgDialLookAndFeel> blueDialLookAndFeel;
     std::unique_ptr<SvgDialLookAndFeel> grayDialLookAndFeel;
     std::unique_ptr<SvgDialLookAndFeel> darkDialLookAndFeel;
-    std::unique_ptr<juce::Drawable> logoDrawable;
-    std::unique_ptr<juce::Drawable> dualVcoDrawable;
+    const juce::Drawable* logoDrawable = nullptr;
+    const juce::Drawable* dualVcoDrawable = nullptr;
     juce::AffineTransform logoTransform;
     juce::AffineTransform dualVcoTransform;
     juce::Rectangle<int> contentPanelBounds;
@@ -122,6 +153,11 @@ private:
     float logoScale = 1.0f;
     float dualVcoScale = 1.0f;
     float dualVcoLabelFontHeight = 14.0f;
+    juce::Image staticLayer;
+    float staticLayerPixelScale = 0.0f;
+    bool cacheStaticLayer = true;
+    bool stereoControlsShown = true;
+    bool pairControlsShown = true;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DualToneGeneratorAudioProcessorEditor)
 };
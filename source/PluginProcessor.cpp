@@ -1,19 +1,16 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
-#include <cmath>
-#include <utility>
-
 namespace
 {
-inline std::pair<float, float> calculatePanGains(float pan)
-{
-    const auto clipped = juce::jlimit(-1.0f, 1.0f, pan);
-    const auto angle = (clipped + 1.0f) * 0.5f * juce::MathConstants<float>::halfPi;
-    const auto left = std::cos(angle);
-    const auto right = std::sin(angle);
-    return { left, right };
-}
+const juce::Identifier toneBankType { "TONE_BANK" };
+const juce::Identifier partialType { "PARTIAL" };
+const juce::Identifier offsetProperty { "offset" };
+const juce::Identifier levelProperty { "level" };
+const juce::Identifier panProperty { "pan" };
+
+// The parameters the engine's latency depends on, besides the tone bank
+const char* const latencyParameterIDs[] = { "oversampling", "voiceMode" };
 } // namespace
 
 DualToneGeneratorAudioProcessor::DualToneGeneratorAudioProcessor()
@@ -21,39 +18,76 @@ DualToneGeneratorAudioProcessor::DualToneGeneratorAudioProcessor()
           BusesProperties().withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       parameters(*this, nullptr, "PARAMETERS", createParameterLayout())
 {
-    centerFrequencyParam = parameters.getRawParameterValue("centerFreq");
-    spreadParam = parameters.getRawParameterValue("spread");
-    panOneParam = parameters.getRawParameterValue("pan1");
-    panTwoParam = parameters.getRawParameterValue("pan2");
-    attenuationOneParam = parameters.getRawParameterValue("atten1");
-    attenuationTwoParam = parameters.getRawParameterValue("atten2");
-    gainParam = parameters.getRawParameterValue("gain");
-    driveParam = parameters.getRawParameterValue("drive");
-    shapeTypeParam = parameters.getRawParameterValue("shapeType");
+    for (size_t index = 0; index < stateValues.size(); ++index)
+    {
+        stateValues[index] = parameters.getRawParameterValue(PluginState::parameterIDs[index]);
+        stateParameters[index] = parameters.getParameter(PluginState::parameterIDs[index]);
+        jassert(stateValues[index] != nullptr && stateParameters[index] != nullptr);
+    }
+
+    engine.setParameterValues(stateValues);
+    getPresetBank().add("Init", getDefaultState());
+    updateReportedLatency();
+    engine.attachWorker(*backgroundWorker);
+
+    for (const auto* parameterID : latencyParameterIDs)
+        parameters.addParameterListener(parameterID, &latencyReporter);
+
+    hostSync.startTimer(50);
+}
+
+DualToneGeneratorAudioProcessor::~DualToneGeneratorAudioProcessor()
+{
+    hostSync.stopTimer();
+
+    for (const auto* parameterID : latencyParameterIDs)
+        parameters.removeParameterListener(parameterID, &latencyReporter);
+
+    engine.detachWorker(*backgroundWorker);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout DualToneGeneratorAudioProcessor::createParameterLayout()
 {
     using juce::AudioParameterFloat;
-    using juce::NormalisableRange;
+    using Parameter = PluginState::Parameter;
+
+    // Ranges and defaults come from PluginState, which everything outside the value tree clamps to as well
+    auto rangeOf = [](Parameter parameter)
+    {
+        const auto& range = PluginState::parameterRanges[parameter];
+        return juce::NormalisableRange<float>(range.minimum, range.maximum, range.interval, range.skew);
+    };
+
+    auto defaultOf = [](Parameter parameter) { return PluginState::parameterRanges[parameter].defaultValue; };
+    auto idOf = [](Parameter parameter) { return PluginState::parameterIDs[parameter]; };
 
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
-    auto centerRange = NormalisableRange<float>(60.0f, 600.0f, 0.001f, 0.3f);
-    auto spreadRange = NormalisableRange<float>(0.0f, 20.0f, 0.001f, 0.6f);
-    layout.add(std::make_unique<AudioParameterFloat>("centerFreq", "Center (Hz)", centerRange, 100.0f));
-    layout.add(std::make_unique<AudioParameterFloat>("spread", "Spread (Hz)", spreadRange, 2.0f));
-    layout.add(std::make_unique<AudioParameterFloat>("pan1", "Pan 1", -1.0f, 1.0f, -1.0f));
-    layout.add(std::make_unique<AudioParameterFloat>("pan2", "Pan 2", -1.0f, 1.0f, 1.0f));
-    auto attenuationRange = NormalisableRange<float>(-24.0f, 0.0f, 0.01f);
-    auto gainRange = NormalisableRange<float>(-12.0f, 12.0f, 0.01f);
-    const auto defaultGainDb = 0.0f;
-    layout.add(std::make_unique<AudioParameterFloat>("atten1", "Attenuation 1", attenuationRange, 0.0f, "dB"));
-    layout.add(std::make_unique<AudioParameterFloat>("atten2", "Attenuation 2", attenuationRange, 0.0f, "dB"));
-    layout.add(std::make_unique<AudioParameterFloat>("gain", "Gain", gainRange, defaultGainDb, "dB"));
-    auto driveRange = NormalisableRange<float>(-24.0f, 12.0f, 0.01f);
-    layout.add(std::make_unique<AudioParameterFloat>("drive", "Drive", driveRange, -24.0f, "dB"));
-    auto shapeTypeRange = NormalisableRange<float>(0.0f, 1.0f, 0.001f);
+    auto addFloat = [&](Parameter parameter, const juce::String& name, juce::AudioParameterFloatAttributes attributes = {})
+    {
+        layout.add(std::make_unique<AudioParameterFloat>(idOf(parameter), name, rangeOf(parameter), defaultOf(parameter), attributes));
+    };
+
+    auto addChoice = [&](Parameter parameter, const juce::String& name, const juce::StringArray& choices)
+    {
+        jassert(PluginState::parameterRanges[parameter].isChoice
+                && choices.size() == juce::roundToInt(PluginState::parameterRanges[parameter].maximum) + 1);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(idOf(parameter),
+                                                                name,
+                                                                choices,
+                                                                juce::roundToInt(defaultOf(parameter))));
+    };
+
+    const auto decibels = juce::AudioParameterFloatAttributes().withLabel("dB");
+
+    addFloat(PluginState::centerFreq, "Center (Hz)");
+    addFloat(PluginState::spread, "Spread (Hz)");
+    addFloat(PluginState::pan1, "Pan 1");
+    addFloat(PluginState::pan2, "Pan 2");
+    addFloat(PluginState::atten1, "Attenuation 1", decibels);
+    addFloat(PluginState::atten2, "Attenuation 2", decibels);
+    addFloat(PluginState::gain, "Gain", decibels);
+    addFloat(PluginState::drive, "Drive", decibels);
     auto shapeTypeAttributes = juce::AudioParameterFloatAttributes()
                                    .withStringFromValueFunction([](float value, int)
                                                                 {
@@ -63,11 +97,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout DualToneGeneratorAudioProces
                                                                 {
                                                                     return text.trimCharactersAtEnd("%").getFloatValue() * 0.01f;
                                                                 });
-    layout.add(std::make_unique<AudioParameterFloat>("shapeType",
-                                                     "Shape Type",
-                                                     shapeTypeRange,
-                                                     0.0f,
-                                                     shapeTypeAttributes));
+    addFloat(PluginState::shapeType, "Shape Type", shapeTypeAttributes);
+    addChoice(PluginState::shapeMode, "Shape Mode", { "Direct", "Harmonic" });
+    addChoice(PluginState::oversampling, "Oversampling", { "Off", "2x", "4x", "8x" });
+    addChoice(PluginState::voiceMode, "Voice Mode", { "Drone", "MIDI" });
+
+    // Only takes effect while a morph path is set; see setMorphStates
+    addFloat(PluginState::morph, "Morph");
 
     return layout;
 }
@@ -95,143 +131,276 @@ bool DualToneGeneratorAudioProcessor::isStereoOutput() const
 void DualToneGeneratorAudioProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/)
 {
     currentSampleRate = sampleRate;
+    loadMeter.prepare(sampleRate);
+    scopeFifo.prepare(sampleRate);
+
+    engine.prepare(sampleRate);
+    numChannelsChanged();
+    updateReportedLatency();
 }
 
 void DualToneGeneratorAudioProcessor::releaseResources()
 {
 }
 
+double DualToneGeneratorAudioProcessor::getTailLengthSeconds() const
+{
+    // The oversampling filters keep ringing for their latency after the tones stop
+    return currentSampleRate > 0.0 ? static_cast<double>(getLatencySamples()) / currentSampleRate : 0.0;
+}
+
+void DualToneGeneratorAudioProcessor::updateReportedLatency()
+{
+    const auto latency = engine.getLatencyInSamples();
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+void DualToneGeneratorAudioProcessor::updateLatencyIfChanged()
+{
+    if (latencyReporter.latencyChanged.exchange(false))
+        updateReportedLatency();
+}
+
+void DualToneGeneratorAudioProcessor::LatencyReporter::parameterChanged(const juce::String&, float)
+{
+    // Posting a message would lock the message queue, so other threads leave the host to the timer
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        owner.updateReportedLatency();
+    else
+        latencyChanged = true;
+}
+
+void DualToneGeneratorAudioProcessor::numChannelsChanged()
+{
+    if (auto* bus = getBus(false, 0))
+        engine.setChannelLayout(bus->getCurrentLayout());
+}
+
 bool DualToneGeneratorAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    // Only allow mono or stereo outputs, no inputs needed for a synth
-    if (layouts.getMainOutputChannelSet() == juce::AudioChannelSet::mono()
-        || layouts.getMainOutputChannelSet() == juce::AudioChannelSet::stereo())
+    // No inputs needed for a synth. Speaker layouts use the pairwise panner, ambisonic
+    // outputs up to third order are encoded in AmbiX
+    const auto& output = layouts.getMainOutputChannelSet();
+
+    if (output == juce::AudioChannelSet::mono()
+        || output == juce::AudioChannelSet::stereo()
+        || output == juce::AudioChannelSet::quadraphonic()
+        || output == juce::AudioChannelSet::create5point1()
+        || output == juce::AudioChannelSet::create7point1())
         return true;
 
-    return false;
+    const auto ambisonicOrder = output.getAmbisonicOrder();
+    return ambisonicOrder >= 1 && ambisonicOrder <= 3;
+}
+
+void DualToneGeneratorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    const ProcessLoadMeter::ScopedBlock timing(loadMeter, buffer.getNumSamples());
+    engine.setNonRealtime(isNonRealtime());
+    engine.process(buffer, midiMessages);
+    scopeFifo.push(buffer);
+    midiMessages.clear();
+}
+
+void DualToneGeneratorAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    const ProcessLoadMeter::ScopedBlock timing(loadMeter, buffer.getNumSamples());
+    engine.setNonRealtime(isNonRealtime());
+    engine.process(buffer, midiMessages);
+    scopeFifo.push(buffer);
+    midiMessages.clear();
 }
 
-template <typename SampleType>
-void DualToneGeneratorAudioProcessor::processBlockInternal(juce::AudioBuffer<SampleType>& buffer)
+void DualToneGeneratorAudioProcessor::seekTo(juce::int64 samplePosition)
 {
-    juce::ScopedNoDenormals disableDenormals;
-    const auto numChannels = buffer.getNumChannels();
-    const auto numSamples = buffer.getNumSamples();
+    engine.seekTo(samplePosition);
+}
 
-    buffer.clear();
+void DualToneGeneratorAudioProcessor::setToneBank(const ToneBankLayout& layout)
+{
+    engine.setToneBank(layout);
+    updateReportedLatency();
 
-    if (numSamples == 0)
-        return;
+    // Keep the partials in the parameter state so they are saved and restored with it
+    auto bankState = parameters.state.getOrCreateChildWithName(toneBankType, nullptr);
+    bankState.removeAllChildren(nullptr);
 
-    const auto centerFrequency = static_cast<double>(centerFrequencyParam->load());
-    const auto spread = static_cast<double>(spreadParam->load());
-    const auto freq1 = juce::jmax(0.0, centerFrequency - spread);
-    const auto freq2 = juce::jmax(0.0, centerFrequency + spread);
-    const auto attenuationOne = juce::Decibels::decibelsToGain(attenuationOneParam != nullptr ? attenuationOneParam->load()
-                                                                                              : 0.0f);
-    const auto attenuationTwo = juce::Decibels::decibelsToGain(attenuationTwoParam != nullptr ? attenuationTwoParam->load()
-                                                                                              : 0.0f);
-    const auto gainDb = gainParam != nullptr ? gainParam->load() : 0.0f;
-    const auto gain = juce::Decibels::decibelsToGain(gainDb);
-    const auto driveDb = static_cast<double>(driveParam != nullptr ? driveParam->load() : -24.0f);
-    const auto driveAmount = std::pow(10.0, driveDb / 20.0);
-    const auto tanhDenominator = std::tanh(driveAmount);
-    const auto tanhScale = tanhDenominator != 0.0 ? (1.0 / tanhDenominator) : 1.0;
-    const auto atanDenominator = std::atan(driveAmount);
-    const auto atanScale = atanDenominator != 0.0 ? (1.0 / atanDenominator) : 1.0;
-    const auto typeMix = juce::jlimit(0.0f, 1.0f, shapeTypeParam != nullptr ? shapeTypeParam->load() : 0.0f);
-    const bool stereo = (numChannels >= 2);
-
-    const auto increment1 = (juce::MathConstants<double>::twoPi * freq1) / currentSampleRate;
-    const auto increment2 = (juce::MathConstants<double>::twoPi * freq2) / currentSampleRate;
-
-    const auto baseGain = juce::Decibels::decibelsToGain(-12.0f);
-    const auto toneGain = baseGain * gain;
-
-    float leftGain1 = 1.0f, rightGain1 = stereo ? 0.0f : 1.0f;
-    float leftGain2 = 1.0f, rightGain2 = stereo ? 0.0f : 1.0f;
-
-    if (stereo)
+    for (int partial = 0; partial < juce::jlimit(0, ToneBankLayout::maxPartials, layout.numPartials); ++partial)
     {
-        const auto [l1, r1] = calculatePanGains(panOneParam->load());
-        const auto [l2, r2] = calculatePanGains(panTwoParam->load());
-        leftGain1 = l1;
-        rightGain1 = r1;
-        leftGain2 = l2;
-        rightGain2 = r2;
+        juce::ValueTree partialState(partialType);
+        partialState.setProperty(offsetProperty, layout.offsetsHz[partial], nullptr);
+        partialState.setProperty(levelProperty, layout.levels[partial], nullptr);
+        partialState.setProperty(panProperty, layout.pans[partial], nullptr);
+        bankState.appendChild(partialState, nullptr);
     }
+}
+
+void DualToneGeneratorAudioProcessor::setMorphStates(const std::vector<PluginState>& states)
+{
+    engine.setMorphStates(states);
+}
 
-    for (int sample = 0; sample < numSamples; ++sample)
+bool DualToneGeneratorAudioProcessor::setMorphPrograms(const std::vector<int>& programIndices)
+{
+    std::vector<PluginState> states;
+
+    for (const auto index : programIndices)
     {
-        const auto wave1 = static_cast<float>(std::sin(phaseOne));
-        const auto wave2 = static_cast<float>(std::sin(phaseTwo));
+        const auto* preset = getPresetBank().get(index);
 
-        phaseOne += increment1;
-        phaseTwo += increment2;
+        if (preset == nullptr)
+            return false;
 
-        if (phaseOne >= juce::MathConstants<double>::twoPi)
-            phaseOne -= juce::MathConstants<double>::twoPi;
-        if (phaseTwo >= juce::MathConstants<double>::twoPi)
-            phaseTwo -= juce::MathConstants<double>::twoPi;
+        states.push_back(preset->state);
+    }
 
-        const auto tanhWave1 = std::tanh(static_cast<double>(wave1) * driveAmount) * tanhScale;
-        const auto tanhWave2 = std::tanh(static_cast<double>(wave2) * driveAmount) * tanhScale;
-        const auto atanWave1 = std::atan(static_cast<double>(wave1) * driveAmount) * atanScale;
-        const auto atanWave2 = std::atan(static_cast<double>(wave2) * driveAmount) * atanScale;
-        const auto shapedWave1 = static_cast<SampleType>((1.0 - static_cast<double>(typeMix)) * tanhWave1
-                                                         + static_cast<double>(typeMix) * atanWave1);
-        const auto shapedWave2 = static_cast<SampleType>((1.0 - static_cast<double>(typeMix)) * tanhWave2
-                                                         + static_cast<double>(typeMix) * atanWave2);
+    setMorphStates(states);
+    return true;
+}
 
-        auto tone1 = static_cast<SampleType>(shapedWave1 * toneGain);
-        auto tone2 = static_cast<SampleType>(shapedWave2 * toneGain);
+PluginState DualToneGeneratorAudioProcessor::getDefaultState() const
+{
+    PluginState state;
 
-        tone1 = static_cast<SampleType>(tone1 * attenuationOne);
-        tone2 = static_cast<SampleType>(tone2 * attenuationTwo);
+    for (size_t index = 0; index < stateParameters.size(); ++index)
+    {
+        const auto* parameter = stateParameters[index];
+        state.values[index] = parameter->convertFrom0to1(parameter->getDefaultValue());
+    }
 
-        if (stereo)
-        {
-            const auto leftValue = (tone1 * static_cast<SampleType>(leftGain1))
-                                   + (tone2 * static_cast<SampleType>(leftGain2));
-            const auto rightValue = (tone1 * static_cast<SampleType>(rightGain1))
-                                    + (tone2 * static_cast<SampleType>(rightGain2));
+    return state;
+}
 
-            buffer.setSample(0, sample, static_cast<SampleType>(leftValue));
-            buffer.setSample(1, sample, static_cast<SampleType>(rightValue));
-        }
-        else
+PluginState DualToneGeneratorAudioProcessor::captureState() const
+{
+    PluginState state;
+
+    for (size_t index = 0; index < stateValues.size(); ++index)
+        state.values[index] = stateValues[index]->load();
+
+    state.toneBank = engine.getToneBankLayout();
+    return state;
+}
+
+void DualToneGeneratorAudioProcessor::applyState(const PluginState& state)
+{
+    // Presets the audio thread switched to before now are superseded by the values written here
+    const auto presetOverride = engine.getPresetOverrideGeneration();
+
+    {
+        const auto batch = engine.batchParameterChanges();
+
+        for (size_t index = 0; index < stateParameters.size(); ++index)
         {
-            const auto monoValue = (tone1 + tone2) * static_cast<SampleType>(0.5);
-            buffer.setSample(0, sample, static_cast<SampleType>(monoValue));
+            auto* parameter = stateParameters[index];
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(state.values[index]));
         }
+
+        setToneBank(state.toneBank);
     }
+
+    engine.releasePresetOverride(presetOverride);
 }
 
-void DualToneGeneratorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void DualToneGeneratorAudioProcessor::mirrorAppliedPreset()
 {
-    midiMessages.clear();
-    processBlockInternal(buffer);
+    if (const auto* preset = getPresetBank().takeApplied())
+        applyState(preset->state);
 }
 
-void DualToneGeneratorAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+void DualToneGeneratorAudioProcessor::HostSync::timerCallback()
 {
-    midiMessages.clear();
-    processBlockInternal(buffer);
+    owner.mirrorAppliedPreset();
+    owner.updateLatencyIfChanged();
+}
+
+int DualToneGeneratorAudioProcessor::getNumPrograms()
+{
+    return juce::jmax(1, getPresetBank().size());
+}
+
+int DualToneGeneratorAudioProcessor::getCurrentProgram()
+{
+    return getPresetBank().getCurrentIndex();
+}
+
+void DualToneGeneratorAudioProcessor::setCurrentProgram(int index)
+{
+    // The host's choice goes through the parameters only, reaching the audio thread as one batch.
+    // It supersedes any MIDI switch the audio thread has made, so that one is not mirrored later
+    if (const auto* preset = getPresetBank().select(index))
+    {
+        getPresetBank().takeApplied();
+        applyState(preset->state);
+    }
+}
+
+const juce::String DualToneGeneratorAudioProcessor::getProgramName(int index)
+{
+    const auto* preset = getPresetBank().get(index);
+    return preset != nullptr ? preset->name : juce::String();
+}
+
+void DualToneGeneratorAudioProcessor::changeProgramName(int index, const juce::String& newName)
+{
+    getPresetBank().rename(index, newName);
+}
+
+int DualToneGeneratorAudioProcessor::addProgram(const juce::String& name)
+{
+    mirrorAppliedPreset();
+    return getPresetBank().add(name, captureState());
 }
 
 void DualToneGeneratorAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = parameters.copyState();
-    if (auto xml = state.createXml())
-        copyXmlToBinary(*xml, destData);
+    // A preset switched to by MIDI since the last timer tick is saved with its tone bank
+    mirrorAppliedPreset();
+    captureState().writeBinary(destData);
 }
 
 void DualToneGeneratorAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    const auto size = static_cast<size_t>(juce::jmax(0, sizeInBytes));
+
+    if (PluginState::isBinary(data, size))
+    {
+        // Anything the data predates starts from its default
+        auto state = getDefaultState();
+
+        if (state.readBinary(data, size))
+            applyState(state);
+
+        return;
+    }
+
+    // Sessions saved before the binary format hold the parameter tree as XML
     if (auto xml = getXmlFromBinary(data, sizeInBytes))
     {
         if (xml->hasTagName(parameters.state.getType()))
+        {
+            const auto batch = engine.batchParameterChanges();
             parameters.replaceState(juce::ValueTree::fromXml(*xml));
+
+            ToneBankLayout layout;
+            const auto bankState = parameters.state.getChildWithName(toneBankType);
+
+            for (const auto& partialState : bankState)
+            {
+                if (layout.numPartials == ToneBankLayout::maxPartials)
+                    break;
+
+                layout.offsetsHz[layout.numPartials] = partialState.getProperty(offsetProperty, 0.0);
+                layout.levels[layout.numPartials] = partialState.getProperty(levelProperty, 0.0);
+                layout.pans[layout.numPartials] = partialState.getProperty(panProperty, 0.0);
+                ++layout.numPartials;
+            }
+
+            engine.setToneBank(layout);
+            updateReportedLatency();
+        }
     }
 }
 
@@ -2,19 +2,27 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 
+#include "AudioScopeFifo.h"
+#include "BackgroundWorker.h"
+#include "DualToneEngine.h"
+#include "EditorAssets.h"
+#include "ProcessLoadMeter.h"
+
 class DualToneGeneratorAudioProcessor : public juce::AudioProcessor
 {
 public:
     DualToneGeneratorAudioProcessor();
-    ~DualToneGeneratorAudioProcessor() override = default;
+    ~DualToneGeneratorAudioProcessor() override;
 
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+    void numChannelsChanged() override;
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -26,43 +34,125 @@ public:
     bool acceptsMidi() const override { return true; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override;
 
     //==============================================================================
-    int getNumPrograms() override { return 1; }
-    int getCurrentProgram() override { return 0; }
-    void setCurrentProgram(int) override {}
-    const juce::String getProgramName(int) override { return {}; }
-    void changeProgramName(int, const juce::String&) override {}
+    // Programs are the entries of the preset bank. Selecting one, from the host or by a MIDI program
+    // change, takes effect whole at the start of the next block. A MIDI program change reaches the
+    // parameters from the message thread shortly after.
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    // Stores the current parameters and tone bank as a new program. Returns its index, or -1 once
+    // the bank is full.
+    int addProgram(const juce::String& name);
+    PresetBank& getPresetBank() noexcept { return engine.getPresetBank(); }
 
     //==============================================================================
+    // Saves the binary PluginState layout. Loading also accepts the XML state of earlier versions.
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
     juce::AudioProcessorValueTreeState& getValueTreeState() { return parameters; }
+
+    // Parameter changes made while the returned batch is in scope reach the audio thread together,
+    // at the start of one block, rather than spread over whichever blocks they happen to land in.
+    // Any thread; keep the batch short, as processing holds the previous values until it ends.
+    [[nodiscard]] ParameterSnapshot::ScopedBatch batchParameterChanges() noexcept { return engine.batchParameterChanges(); }
+
+    // Replaces the Center/Spread tone pair with a bank of partials around Center, or restores
+    // the pair when the layout has no partials. The change glides like a parameter change. While
+    // a bank plays, Spread, the pans and the attenuations have no effect. Message thread; the
+    // layout is saved with the state.
+    void setToneBank(const ToneBankLayout& layout);
+
+    // Hands the tone controls over to the Morph parameter, which then moves through these states
+    // from first to last. Center, Spread, the pans, the attenuations, Gain, Drive and Type are
+    // interpolated; the other settings stay with their controls. Fewer than two states end the
+    // morph. Builds a shaper table per state, so call it from the message thread. Not saved with
+    // the state.
+    void setMorphStates(const std::vector<PluginState>& states);
+
+    // Morphs through these programs of the preset bank. False, changing nothing, if one does not exist.
+    bool setMorphPrograms(const std::vector<int>& programIndices);
+
+    // Starts the next block at exactly the tone phases reached samplePosition samples after phase zero
+    // at the current parameter values, as if the processor had been running since then. Constant time
+    // for any position, so it also serves transport sync and sample-accurate restarts. Call it between
+    // prepareToPlay() and processBlock(), never concurrently with processing; parameter ramps are not
+    // replayed. Offline renders use it to start each chunk of a timeline independently.
+    void seekTo(juce::int64 samplePosition);
     bool isStereoOutput() const;
+    bool isToneBankActive() const noexcept { return engine.isToneBankActive(); }
+
+    // DSP load of recent processBlock calls, for display; read it from the message thread.
+    const ProcessLoadMeter& getLoadMeter() const noexcept { return loadMeter; }
+
+    // Decimated copy of the output for the editor's scope; only filled while the scope is switched on.
+    AudioScopeFifo& getScopeFifo() noexcept { return scopeFifo; }
 
 private:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    template <typename SampleType>
-    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer);
+    // Message thread or prepareToPlay only, as it notifies the host.
+    void updateReportedLatency();
+
+    PluginState getDefaultState() const;
+    PluginState captureState() const;
+
+    // Message thread: moves every parameter to the state's value, telling the host, and installs its tone bank.
+    void applyState(const PluginState& state);
+
+    // Message thread: applies the preset the audio thread last switched to, if any, through the parameters.
+    void mirrorAppliedPreset();
+
+    // Message thread: reports the latency again if a parameter it depends on changed elsewhere.
+    void updateLatencyIfChanged();
+
+    // Keeps the reported latency in step with the parameters it depends on. Host automation
+    // usually arrives on the audio thread, which must not notify the host or post a message, so
+    // a change made anywhere but the message thread only sets a flag for the sync timer.
+    struct LatencyReporter : public juce::AudioProcessorValueTreeState::Listener
+    {
+        explicit LatencyReporter(DualToneGeneratorAudioProcessor& processorToUpdate) : owner(processorToUpdate) {}
+        void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+        DualToneGeneratorAudioProcessor& owner;
+        std::atomic<bool> latencyChanged { false };
+    };
+
+    // Brings the host's view in line with what changed off the message thread: presets the audio
+    // thread switched to on its own, and the latency of automated parameters.
+    struct HostSync : public juce::Timer
+    {
+        explicit HostSync(DualToneGeneratorAudioProcessor& processorToUpdate) : owner(processorToUpdate) {}
+        void timerCallback() override;
+
+        DualToneGeneratorAudioProcessor& owner;
+    };
 
     juce::AudioProcessorValueTreeState parameters;
 
-    std::atomic<float>* centerFrequencyParam = nullptr;
-    std::atomic<float>* spreadParam = nullptr;
-    std::atomic<float>* panOneParam = nullptr;
-    std::atomic<float>* panTwoParam = nullptr;
-    std::atomic<float>* attenuationOneParam = nullptr;
-    std::atomic<float>* attenuationTwoParam = nullptr;
-    std::atomic<float>* gainParam = nullptr;
-    std::atomic<float>* driveParam = nullptr;
-    std::atomic<float>* shapeTypeParam = nullptr;
+    // Every parameter in PluginState::parameterIDs order, as raw values and as host parameters.
+    DualToneEngine::ParameterValues stateValues {};
+    std::array<juce::RangedAudioParameter*, PluginState::numParameters> stateParameters {};
 
+    // Renders every block from the raw values above.
+    DualToneEngine engine;
     double currentSampleRate = 44100.0;
-    double phaseOne = 0.0;
-    double phaseTwo = 0.0;
+
+    juce::SharedResourcePointer<BackgroundWorker> backgroundWorker;
+    LatencyReporter latencyReporter { *this };
+    HostSync hostSync { *this };
+
+    ProcessLoadMeter loadMeter;
+    AudioScopeFifo scopeFifo;
+
+    // Keeps the parsed editor assets alive between editor openings, for as long as any instance exists.
+    juce::SharedResourcePointer<EditorAssets> editorAssets;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DualToneGeneratorAudioProcessor)
 };
@@ -0,0 +1,173 @@
+#include "PluginState.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+constexpr char magic[4] = { 'D', 'T', 'G', 'S' };
+constexpr size_t headerSize = 16;
+
+void writeUInt32(char* destination, std::uint32_t value) noexcept
+{
+    value = juce::ByteOrder::swapIfBigEndian(value);
+    std::memcpy(destination, &value, sizeof(value));
+}
+
+void writeFloat(char* destination, float value) noexcept
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeUInt32(destination, bits);
+}
+
+void writeDouble(char* destination, double value) noexcept
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = juce::ByteOrder::swapIfBigEndian(bits);
+    std::memcpy(destination, &bits, sizeof(bits));
+}
+
+std::uint32_t readUInt32(const char* source) noexcept
+{
+    return juce::ByteOrder::littleEndianInt(source);
+}
+
+float readFloat(const char* source) noexcept
+{
+    const auto bits = readUInt32(source);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double readDouble(const char* source) noexcept
+{
+    const auto bits = juce::ByteOrder::littleEndianInt64(source);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+} // namespace
+
+const char* const PluginState::parameterIDs[numParameters] = {
+    "centerFreq", "spread", "pan1", "pan2", "atten1", "atten2",
+    "gain", "drive", "shapeType", "shapeMode", "oversampling", "voiceMode", "morph"
+};
+
+const PluginState::ParameterRange PluginState::parameterRanges[numParameters] = {
+    { 60.0f, 600.0f, 100.0f, 0.001f, 0.3f, false },  // centerFreq (Hz)
+    { 0.0f, 20.0f, 2.0f, 0.001f, 0.6f, false },      // spread (Hz)
+    { -1.0f, 1.0f, -1.0f, 0.0f, 1.0f, false },       // pan1
+    { -1.0f, 1.0f, 1.0f, 0.0f, 1.0f, false },        // pan2
+    { -24.0f, 0.0f, 0.0f, 0.01f, 1.0f, false },      // atten1 (dB)
+    { -24.0f, 0.0f, 0.0f, 0.01f, 1.0f, false },      // atten2 (dB)
+    { -12.0f, 12.0f, 0.0f, 0.01f, 1.0f, false },     // gain (dB)
+    { -24.0f, 12.0f, -24.0f, 0.01f, 1.0f, false },   // drive (dB)
+    { 0.0f, 1.0f, 0.0f, 0.001f, 1.0f, false },       // shapeType
+    { 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, true },          // shapeMode: Direct, Harmonic
+    { 0.0f, 3.0f, 0.0f, 1.0f, 1.0f, true },          // oversampling: Off, 2x, 4x, 8x
+    { 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, true },          // voiceMode: Drone, MIDI
+    { 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, false }          // morph
+};
+
+float PluginState::ParameterRange::constrain(float value) const noexcept
+{
+    const auto clamped = std::clamp(value, minimum, maximum);
+    return isChoice ? std::round(clamped) : clamped;
+}
+
+void PluginState::writeBinary(juce::MemoryBlock& destData) const
+{
+    const auto numPartials = static_cast<size_t>(juce::jlimit(0, ToneBankLayout::maxPartials, toneBank.numPartials));
+    destData.setSize(headerSize + numParameters * sizeof(float) + 3 * numPartials * sizeof(double));
+
+    auto* data = static_cast<char*>(destData.getData());
+    std::memcpy(data, magic, sizeof(magic));
+    writeUInt32(data + 4, formatVersion);
+    writeUInt32(data + 8, static_cast<std::uint32_t>(numParameters));
+    writeUInt32(data + 12, static_cast<std::uint32_t>(numPartials));
+    data += headerSize;
+
+    for (const auto value : values)
+    {
+        writeFloat(data, value);
+        data += sizeof(float);
+    }
+
+    for (const auto* partialValues : { toneBank.offsetsHz, toneBank.levels, toneBank.pans })
+    {
+        for (size_t partial = 0; partial < numPartials; ++partial)
+        {
+            writeDouble(data, partialValues[partial]);
+            data += sizeof(double);
+        }
+    }
+}
+
+bool PluginState::readBinary(const void* data, size_t sizeInBytes)
+{
+    if (! isBinary(data, sizeInBytes))
+        return false;
+
+    const auto* source = static_cast<const char*>(data);
+
+    if (readUInt32(source + 4) > formatVersion)
+        return false;
+
+    const auto storedParameters = static_cast<size_t>(readUInt32(source + 8));
+    const auto numPartials = static_cast<size_t>(readUInt32(source + 12));
+
+    if (numPartials > static_cast<size_t>(ToneBankLayout::maxPartials) || storedParameters > 0xffff
+        || sizeInBytes < headerSize + storedParameters * sizeof(float) + 3 * numPartials * sizeof(double))
+        return false;
+
+    source += headerSize;
+
+    // Everything is checked before anything is kept, so a corrupt blob changes nothing
+    auto newValues = values;
+
+    for (size_t index = 0; index < storedParameters; ++index)
+    {
+        const auto value = readFloat(source);
+        source += sizeof(float);
+
+        if (! std::isfinite(value))
+            return false;
+
+        if (index < newValues.size())
+            newValues[index] = parameterRanges[index].constrain(value);
+    }
+
+    ToneBankLayout layout;
+    layout.numPartials = static_cast<int>(numPartials);
+
+    for (auto* partialValues : { layout.offsetsHz, layout.levels, layout.pans })
+    {
+        for (size_t partial = 0; partial < numPartials; ++partial)
+        {
+            partialValues[partial] = readDouble(source);
+            source += sizeof(double);
+
+            if (! std::isfinite(partialValues[partial]))
+                return false;
+        }
+    }
+
+    for (size_t partial = 0; partial < numPartials; ++partial)
+    {
+        layout.levels[partial] = std::max(0.0, layout.levels[partial]);
+        layout.pans[partial] = std::clamp(layout.pans[partial], -1.0, 1.0);
+    }
+
+    values = newValues;
+    toneBank = layout;
+    return true;
+}
+
+bool PluginState::isBinary(const void* data, size_t sizeInBytes) noexcept
+{
+    return data != nullptr && sizeInBytes >= headerSize && std::memcmp(data, magic, sizeof(magic)) == 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <cstddef>
+
+#include "ToneBank.h"
+
+// Everything a session saves: each parameter's value in its own units (Hz, dB, pan, choice
+// index) and the tone bank.
+//
+// The binary form is a fixed layout, all little-endian:
+//
+//     offset 0   "DTGS"
+//            4   uint32 format version
+//            8   uint32 number of parameter values (P)
+//           12   uint32 number of partials (N)
+//           16   float32 x P parameter values, in parameterIDs order
+//                float64 x N partial offsets (Hz), then N levels, then N pans
+//
+// New parameters are only ever appended to parameterIDs, so older data simply has fewer values
+// and a reader fills the rest from its defaults. Any other change to the layout bumps the
+// version; data from a newer version is rejected rather than misread.
+struct PluginState
+{
+    // Position of each parameter in values and in the binary layout; never reorder, only append.
+    enum Parameter
+    {
+        centerFreq,
+        spread,
+        pan1,
+        pan2,
+        atten1,
+        atten2,
+        gain,
+        drive,
+        shapeType,
+        shapeMode,
+        oversampling,
+        voiceMode,
+        morph,
+        numParameters
+    };
+
+    static constexpr std::uint32_t formatVersion = 1;
+
+    // Parameter IDs in Parameter order.
+    static const char* const parameterIDs[numParameters];
+
+    // Range of a parameter in its own units. Choices count from 0 in steps of 1.
+    struct ParameterRange
+    {
+        float minimum;
+        float maximum;
+        float defaultValue;
+        float interval;
+        float skew;
+        bool isChoice;
+
+        // Clamps into the range, rounding choices to the nearest index.
+        float constrain(float value) const noexcept;
+    };
+
+    // Ranges in Parameter order. The value tree's layout is built from them, and values that come
+    // from anywhere else are constrained to them.
+    static const ParameterRange parameterRanges[numParameters];
+
+    std::array<float, numParameters> values {};
+    ToneBankLayout toneBank;
+
+    // Replaces the contents of destData.
+    void writeBinary(juce::MemoryBlock& destData) const;
+
+    // Reads the binary form. Values the data does not contain keep what they had, and values outside
+    // their parameter's range are clamped to it. Returns false, leaving the state untouched, if the
+    // data is not the binary form, is truncated or holds a value that is not finite.
+    bool readBinary(const void* data, size_t sizeInBytes);
+
+    static bool isBinary(const void* data, size_t sizeInBytes) noexcept;
+};
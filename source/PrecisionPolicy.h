@@ -0,0 +1,28 @@
+#pragma once
+
+// Arithmetic used by the tone kernels for each processBlock precision.
+//
+// The double overload keeps every stage in double. The float overload runs the oscillator,
+// shaper and mix loops natively in float, which halves their memory traffic and doubles
+// the SIMD width. The phase itself lives in the oscillator's 64-bit fixed-point
+// accumulator, which advances exactly and re-seeds the rotator on every render call, so
+// float rounding only accumulates within one chunk and never across blocks. Stages that
+// keep state between blocks (oversampling filters, the bypass delay, the voice and bank
+// pools) stay in double and convert at their edges.
+template <typename SampleType>
+struct PrecisionPolicy
+{
+    using Kernel = double;
+
+    // Rotator iterations between magnitude corrections.
+    static constexpr int renormaliseInterval = 32;
+};
+
+template <>
+struct PrecisionPolicy<float>
+{
+    using Kernel = float;
+
+    // Float rounding pulls the rotator off the unit circle much sooner.
+    static constexpr int renormaliseInterval = 8;
+};
@@ -0,0 +1,64 @@
+#include "PresetBank.h"
+
+int PresetBank::add(const juce::String& name, const PluginState& state)
+{
+    const auto index = numPresets.load();
+
+    if (index >= maxPresets)
+        return -1;
+
+    auto& preset = presets[static_cast<size_t>(index)];
+    preset = std::make_unique<Preset>(Preset { name, state });
+    entries[static_cast<size_t>(index)].store(preset.get());
+
+    // Publish the count last, so a reader that sees the index also sees the entry
+    numPresets.store(index + 1);
+    return index;
+}
+
+void PresetBank::rename(int index, const juce::String& newName)
+{
+    // The audio thread only ever reads the state, never the name
+    if (juce::isPositiveAndBelow(index, numPresets.load()))
+        presets[static_cast<size_t>(index)]->name = newName;
+}
+
+const PresetBank::Preset* PresetBank::get(int index) const noexcept
+{
+    return juce::isPositiveAndBelow(index, numPresets.load()) ? entries[static_cast<size_t>(index)].load() : nullptr;
+}
+
+const PresetBank::Preset* PresetBank::select(int index) noexcept
+{
+    const auto* preset = get(index);
+
+    if (preset != nullptr)
+    {
+        pending.store(nullptr);
+        currentIndex.store(index);
+    }
+
+    return preset;
+}
+
+bool PresetBank::requestSwitch(int index) noexcept
+{
+    const auto* preset = get(index);
+
+    if (preset == nullptr)
+        return false;
+
+    currentIndex.store(index);
+    pending.store(preset);
+    return true;
+}
+
+const PresetBank::Preset* PresetBank::takePendingSwitch() noexcept
+{
+    const auto* preset = pending.exchange(nullptr);
+
+    if (preset != nullptr)
+        applied.store(preset);
+
+    return preset;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "PluginState.h"
+
+// In-memory presets the audio thread can switch to without locks or allocation.
+//
+// Entries are added on the message thread and never change or move afterwards, so a pointer to
+// one stays valid for the life of the bank. A switch request from the audio thread, for a MIDI
+// program change, stores the entry's pointer; the audio thread takes it with one atomic exchange
+// at the start of its next block and plays the values. The bank then reports the entry it
+// applied, so the message thread can bring the parameters up to date. The message thread selects
+// entries itself and applies them through the parameters. Presets are not saved with the session.
+class PresetBank
+{
+public:
+    struct Preset
+    {
+        juce::String name;
+        PluginState state;
+    };
+
+    // One per MIDI program number.
+    static constexpr int maxPresets = 128;
+
+    //==============================================================================
+    // Message thread
+
+    // Returns the new entry's index, or -1 once the bank is full.
+    int add(const juce::String& name, const PluginState& state);
+    void rename(int index, const juce::String& newName);
+    const Preset* get(int index) const noexcept;
+
+    // The entry the audio thread applied since the last call, if any.
+    const Preset* takeApplied() noexcept { return applied.exchange(nullptr); }
+
+    // Makes the entry current without queueing it for the audio thread, for a caller that applies
+    // it through the parameters. Drops a switch still queued. Returns nullptr if there is no entry.
+    const Preset* select(int index) noexcept;
+
+    //==============================================================================
+    // Any thread
+
+    int size() const noexcept { return numPresets.load(); }
+    int getCurrentIndex() const noexcept { return currentIndex.load(); }
+
+    // Queues the entry for the audio thread's next block. False if there is no such entry.
+    bool requestSwitch(int index) noexcept;
+
+    //==============================================================================
+    // Audio thread
+
+    // The entry requested since the last call, if any; call once per block and apply it whole.
+    const Preset* takePendingSwitch() noexcept;
+
+private:
+    std::array<std::unique_ptr<Preset>, maxPresets> presets;
+    std::array<std::atomic<const Preset*>, maxPresets> entries {};
+    std::atomic<int> numPresets { 0 };
+    std::atomic<int> currentIndex { 0 };
+    std::atomic<const Preset*> pending { nullptr };
+    std::atomic<const Preset*> applied { nullptr };
+};
@@ -0,0 +1,58 @@
+#include "ProcessLoadMeter.h"
+
+#include <algorithm>
+
+ProcessLoadMeter::ProcessLoadMeter() noexcept
+    : secondsPerTick(1.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()))
+{
+}
+
+void ProcessLoadMeter::prepare(double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate;
+    blocksWritten.store(0);
+}
+
+void ProcessLoadMeter::addBlock(juce::int64 elapsedTicks, int numSamples) noexcept
+{
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    const auto deadlineSeconds = static_cast<double>(numSamples) / sampleRate;
+    const auto load = static_cast<double>(elapsedTicks) * secondsPerTick / deadlineSeconds;
+
+    const auto written = blocksWritten.load(std::memory_order_relaxed);
+    loads[written % windowSize].store(static_cast<float>(load * 100.0), std::memory_order_relaxed);
+    blocksWritten.store(written + 1, std::memory_order_release);
+}
+
+ProcessLoadMeter::Stats ProcessLoadMeter::getStats() const noexcept
+{
+    const auto written = blocksWritten.load(std::memory_order_acquire);
+    const auto count = static_cast<int>(std::min<std::uint32_t>(written, windowSize));
+
+    Stats stats;
+    stats.numBlocks = count;
+
+    if (count == 0)
+        return stats;
+
+    std::array<float, windowSize> snapshot;
+    auto sum = 0.0;
+
+    for (int block = 0; block < count; ++block)
+    {
+        snapshot[static_cast<std::size_t>(block)] = loads[static_cast<std::size_t>(block)].load(std::memory_order_relaxed);
+        sum += snapshot[static_cast<std::size_t>(block)];
+    }
+
+    // Nearest-rank percentile: the smallest load that at least 99% of the blocks stay at or below
+    const auto rank = (count * 99 + 99) / 100 - 1;
+    const auto end = snapshot.begin() + count;
+    std::nth_element(snapshot.begin(), snapshot.begin() + rank, end);
+
+    stats.meanPercent = sum / static_cast<double>(count);
+    stats.p99Percent = snapshot[static_cast<std::size_t>(rank)];
+    stats.peakPercent = *std::max_element(snapshot.begin() + rank, end);
+    return stats;
+}
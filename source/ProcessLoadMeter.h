@@ -0,0 +1,74 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Rolling DSP load of the processor, as a percentage of each block's real-time deadline.
+//
+// The audio thread is the only writer: it times each block with the high-resolution tick
+// counter and stores the load into a ring of the most recent blocks with relaxed atomic
+// stores, then bumps the block count. Readers copy the ring and compute the statistics on
+// their own thread, so the audio thread never sorts, waits or allocates. A reader racing the
+// writer may see a slot that was just overwritten, which only swaps one recent block's load
+// for a newer one.
+class ProcessLoadMeter
+{
+public:
+    struct Stats
+    {
+        double meanPercent = 0.0;
+        double p99Percent = 0.0;
+        double peakPercent = 0.0;
+        int numBlocks = 0;
+    };
+
+    // Number of most recent blocks the statistics cover.
+    static constexpr int windowSize = 1024;
+
+    ProcessLoadMeter() noexcept;
+
+    // Message thread, while the audio thread is stopped; forgets all earlier blocks.
+    void prepare(double sampleRate) noexcept;
+
+    // Audio thread: times one block from construction to destruction.
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(ProcessLoadMeter& meterToUse, int numSamplesInBlock) noexcept
+            : meter(meterToUse),
+              numSamples(numSamplesInBlock),
+              startTicks(juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedBlock()
+        {
+            meter.addBlock(juce::Time::getHighResolutionTicks() - startTicks, numSamples);
+        }
+
+    private:
+        ProcessLoadMeter& meter;
+        int numSamples;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+    // Audio thread: records one block that took elapsedTicks to process numSamples.
+    void addBlock(juce::int64 elapsedTicks, int numSamples) noexcept;
+
+    // Any thread but the audio thread.
+    Stats getStats() const noexcept;
+
+private:
+    double secondsPerTick = 0.0;
+    double sampleRate = 44100.0;
+
+    std::array<std::atomic<float>, windowSize> loads {};
+    std::atomic<std::uint32_t> blocksWritten { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProcessLoadMeter)
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Three-slot handoff of a prebuilt resource from one builder thread to the audio thread.
+//
+// The builder always writes into a slot that is neither published nor pinned by the
+// audio thread, then publishes it with a single atomic store. The audio thread pins
+// the published slot for the duration of a block, so it never waits on the builder
+// and never sees a half-written resource.
+template <typename Resource>
+class RealtimeResourceSlots
+{
+public:
+    //==============================================================================
+    // Audio thread
+
+    const Resource* pin() noexcept
+    {
+        for (;;)
+        {
+            const auto ready = readySlot.load();
+
+            if (ready < 0)
+                return nullptr;
+
+            pinnedSlot.store(ready);
+
+            if (readySlot.load() == ready)
+                return &slots[static_cast<std::size_t>(ready)];
+        }
+    }
+
+    void unpin() noexcept { pinnedSlot.store(-1); }
+
+    //==============================================================================
+    // Builder thread
+
+    const Resource* getPublished() const noexcept
+    {
+        const auto ready = readySlot.load();
+        return ready >= 0 ? &slots[static_cast<std::size_t>(ready)] : nullptr;
+    }
+
+    Resource& beginUpdate() noexcept
+    {
+        const auto ready = readySlot.load();
+        const auto pinned = pinnedSlot.load();
+
+        for (int slot = 0; slot < numSlots; ++slot)
+        {
+            if (slot != ready && slot != pinned)
+            {
+                buildingSlot = slot;
+                break;
+            }
+        }
+
+        return slots[static_cast<std::size_t>(buildingSlot)];
+    }
+
+    void publish() noexcept { readySlot.store(buildingSlot); }
+
+    // Calls function on each slot that is neither published nor pinned, e.g. to free what a
+    // superseded resource holds. The same slots beginUpdate() may pick, so equally safe to touch.
+    template <typename Function>
+    void forEachSpareSlot(Function&& function)
+    {
+        const auto ready = readySlot.load();
+        const auto pinned = pinnedSlot.load();
+
+        for (int slot = 0; slot < numSlots; ++slot)
+            if (slot != ready && slot != pinned)
+                function(slots[static_cast<std::size_t>(slot)]);
+    }
+
+private:
+    static constexpr int numSlots = 3;
+
+    std::array<Resource, numSlots> slots;
+    std::atomic<int> readySlot { -1 };
+    std::atomic<int> pinnedSlot { -1 };
+    int buildingSlot = 0;
+};
@@ -0,0 +1,168 @@
+#include "ScopeView.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr float lowestDisplayedFrequency = 20.0f;
+constexpr float highestDisplayedFrequency = 5000.0f;
+} // namespace
+
+ScopeView::ScopeView(AudioScopeFifo& fifoToRead, juce::Colour traceColour, juce::Colour backgroundColour)
+    : fifo(fifoToRead),
+      trace(traceColour),
+      background(backgroundColour),
+      history(static_cast<size_t>(fftSize), 0.0f),
+      incoming(static_cast<size_t>(AudioScopeFifo::capacity), 0.0f),
+      fftData(static_cast<size_t>(fftSize) * 2, 0.0f),
+      spectrumDb(static_cast<size_t>(fftSize / 2), minimumDb),
+      vBlankAttachment(this, [this] { pullSamples(); })
+{
+    setInterceptsMouseClicks(false, false);
+
+    // Whatever is left from an earlier editor is stale
+    while (fifo.pop(incoming.data(), AudioScopeFifo::capacity) > 0)
+    {
+    }
+
+    fifo.setActive(true);
+}
+
+ScopeView::~ScopeView()
+{
+    fifo.setActive(false);
+}
+
+void ScopeView::pullSamples()
+{
+    const auto count = fifo.pop(incoming.data(), AudioScopeFifo::capacity);
+
+    if (count == 0)
+        return;
+
+    for (int i = 0; i < count; ++i)
+    {
+        history[static_cast<size_t>(historyStart)] = incoming[static_cast<size_t>(i)];
+        historyStart = (historyStart + 1) % fftSize;
+    }
+
+    samplesSinceSpectrum += count;
+
+    if (samplesSinceSpectrum >= fftHopSize)
+    {
+        samplesSinceSpectrum = 0;
+        updateSpectrum();
+    }
+
+    repaint(scopePanel);
+    repaint(spectrumPanel);
+}
+
+void ScopeView::updateSpectrum()
+{
+    std::rotate_copy(history.begin(), history.begin() + historyStart, history.end(), fftData.begin());
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // A full-scale sine reads 0 dB: the Hann window halves the peak of an N-point transform of amplitude N/2
+    const auto normalisation = 4.0f / static_cast<float>(fftSize);
+
+    for (size_t bin = 0; bin < spectrumDb.size(); ++bin)
+        spectrumDb[bin] = juce::Decibels::gainToDecibels(fftData[bin] * normalisation, minimumDb);
+}
+
+void ScopeView::setPanelBounds(juce::Rectangle<int> scopeArea, juce::Rectangle<int> spectrumArea)
+{
+    scopePanel = scopeArea;
+    spectrumPanel = spectrumArea;
+    repaint();
+}
+
+void ScopeView::paint(juce::Graphics& g)
+{
+    for (const auto& panel : { scopePanel, spectrumPanel })
+    {
+        if (panel.isEmpty())
+            continue;
+
+        g.setColour(background);
+        g.fillRect(panel);
+        g.setColour(trace.withMultipliedAlpha(0.2f));
+        g.drawRect(panel);
+    }
+
+    if (! scopePanel.isEmpty())
+        paintScope(g, scopePanel.toFloat().reduced(1.0f));
+
+    if (! spectrumPanel.isEmpty())
+        paintSpectrum(g, spectrumPanel.toFloat().reduced(1.0f));
+}
+
+void ScopeView::paintScope(juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    const auto columns = juce::jmax(1, static_cast<int>(area.getWidth()));
+    const auto samplesPerColumn = static_cast<float>(fftSize) / static_cast<float>(columns);
+    const auto halfHeight = area.getHeight() * 0.5f;
+    const auto centreY = area.getCentreY();
+
+    g.setColour(trace);
+
+    // One vertical min/max span per pixel column keeps the cost independent of the history length
+    for (int column = 0; column < columns; ++column)
+    {
+        const auto first = static_cast<int>(static_cast<float>(column) * samplesPerColumn);
+        const auto last = juce::jmax(first + 1, static_cast<int>(static_cast<float>(column + 1) * samplesPerColumn));
+        auto minimum = 1.0f;
+        auto maximum = -1.0f;
+
+        for (int i = first; i < last; ++i)
+        {
+            const auto sample = juce::jlimit(-1.0f, 1.0f, history[static_cast<size_t>((historyStart + i) % fftSize)]);
+            minimum = juce::jmin(minimum, sample);
+            maximum = juce::jmax(maximum, sample);
+        }
+
+        g.drawVerticalLine(static_cast<int>(area.getX()) + column,
+                           centreY - maximum * halfHeight,
+                           centreY - minimum * halfHeight + 1.0f);
+    }
+}
+
+void ScopeView::paintSpectrum(juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    const auto sampleRate = static_cast<float>(fifo.getOutputSampleRate());
+    const auto binWidth = sampleRate / static_cast<float>(fftSize);
+    const auto highest = juce::jmin(highestDisplayedFrequency, sampleRate * 0.5f);
+    const auto columns = juce::jmax(1, static_cast<int>(area.getWidth()));
+    const auto logRange = std::log(highest / lowestDisplayedFrequency);
+    const auto numBins = static_cast<int>(spectrumDb.size());
+
+    juce::Path path;
+
+    for (int column = 0; column < columns; ++column)
+    {
+        // Each column shows the loudest bin in its slice of the log frequency axis
+        const auto lowFrequency = lowestDisplayedFrequency * std::exp(logRange * static_cast<float>(column) / static_cast<float>(columns));
+        const auto highFrequency = lowestDisplayedFrequency * std::exp(logRange * static_cast<float>(column + 1) / static_cast<float>(columns));
+        const auto firstBin = juce::jlimit(0, numBins - 1, static_cast<int>(lowFrequency / binWidth));
+        const auto lastBin = juce::jlimit(firstBin, numBins - 1, static_cast<int>(highFrequency / binWidth));
+        auto level = minimumDb;
+
+        for (int bin = firstBin; bin <= lastBin; ++bin)
+            level = juce::jmax(level, spectrumDb[static_cast<size_t>(bin)]);
+
+        const auto x = area.getX() + static_cast<float>(column);
+        const auto y = juce::jmap(level, minimumDb, 0.0f, area.getBottom(), area.getY());
+
+        if (column == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+
+    g.setColour(trace);
+    g.strokePath(path, juce::PathStrokeType(1.0f));
+}
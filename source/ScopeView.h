@@ -0,0 +1,62 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <vector>
+
+#include "AudioScopeFifo.h"
+
+// Oscilloscope and spectrum of the plugin output, in two panels.
+//
+// The editor places the panels with setPanelBounds() so other controls can sit between them;
+// the rest of the component is transparent and ignores the mouse. The view switches the
+// processor's scope FIFO on for as long as it exists, drains it on every display refresh and
+// repaints only the two panels when new samples arrived. The scope shows the whole
+// history, long enough for several beats; the spectrum is a Hann-windowed FFT of the same
+// history on a log frequency axis, recomputed every fftHopSize new samples.
+class ScopeView : public juce::Component
+{
+public:
+    ScopeView(AudioScopeFifo& fifoToRead, juce::Colour traceColour, juce::Colour backgroundColour);
+    ~ScopeView() override;
+
+    // Both areas are in this component's coordinates.
+    void setPanelBounds(juce::Rectangle<int> scopeArea, juce::Rectangle<int> spectrumArea);
+
+    void paint(juce::Graphics& g) override;
+
+private:
+    static constexpr int fftOrder = 14;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int fftHopSize = 1024;
+    static constexpr float minimumDb = -100.0f;
+
+    void pullSamples();
+    void updateSpectrum();
+    void paintScope(juce::Graphics& g, juce::Rectangle<float> area) const;
+    void paintSpectrum(juce::Graphics& g, juce::Rectangle<float> area) const;
+
+    AudioScopeFifo& fifo;
+    juce::Colour trace;
+    juce::Colour background;
+    juce::Rectangle<int> scopePanel;
+    juce::Rectangle<int> spectrumPanel;
+
+    // Most recent fftSize samples, oldest at historyStart
+    std::vector<float> history;
+    int historyStart = 0;
+    std::vector<float> incoming;
+    int samplesSinceSpectrum = 0;
+
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(fftSize),
+                                                 juce::dsp::WindowingFunction<float>::hann,
+                                                 false };
+    std::vector<float> fftData;
+    std::vector<float> spectrumDb;
+
+    juce::VBlankAttachment vBlankAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeView)
+};
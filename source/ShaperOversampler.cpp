@@ -0,0 +1,76 @@
+#include "ShaperOversampler.h"
+
+ShaperOversampler::ShaperOversampler()
+{
+    using Oversampling = juce::dsp::Oversampling<double>;
+
+    for (int stage = 1; stage < numStages; ++stage)
+    {
+        oversamplers[static_cast<size_t>(stage)] = std::make_unique<Oversampling>(2,
+                                                                                  static_cast<size_t>(stage),
+                                                                                  Oversampling::filterHalfBandFIREquiripple,
+                                                                                  true,
+                                                                                  true);
+        latencies[static_cast<size_t>(stage)] = juce::roundToInt(oversamplers[static_cast<size_t>(stage)]->getLatencyInSamples());
+    }
+}
+
+void ShaperOversampler::prepare(int maximumChunkSize)
+{
+    for (int stage = 1; stage < numStages; ++stage)
+        oversamplers[static_cast<size_t>(stage)]->initProcessing(static_cast<size_t>(maximumChunkSize));
+
+    const auto maxLatency = latencies[numStages - 1];
+
+    for (auto& line : delayLines)
+        line.assign(static_cast<size_t>(juce::jmax(1, maxLatency)), 0.0);
+
+    for (auto& channel : scratch)
+        channel.assign(static_cast<size_t>(maximumChunkSize), 0.0);
+
+    reset();
+}
+
+void ShaperOversampler::reset() noexcept
+{
+    for (int stage = 1; stage < numStages; ++stage)
+        oversamplers[static_cast<size_t>(stage)]->reset();
+
+    for (auto& line : delayLines)
+        std::fill(line.begin(), line.end(), 0.0);
+
+    delayWritePosition = 0;
+}
+
+template <typename SampleType>
+void ShaperOversampler::processBypassed(int stage, SampleType* toneOne, SampleType* toneTwo, int numSamples) noexcept
+{
+    const auto latency = getLatencyInSamples(stage);
+
+    if (latency <= 0)
+        return;
+
+    const auto lineLength = static_cast<int>(delayLines[0].size());
+    SampleType* tones[] = { toneOne, toneTwo };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto readPosition = delayWritePosition - latency;
+        if (readPosition < 0)
+            readPosition += lineLength;
+
+        for (size_t channel = 0; channel < 2; ++channel)
+        {
+            auto& line = delayLines[channel];
+            const auto input = static_cast<double>(tones[channel][i]);
+            tones[channel][i] = static_cast<SampleType>(line[static_cast<size_t>(readPosition)]);
+            line[static_cast<size_t>(delayWritePosition)] = input;
+        }
+
+        if (++delayWritePosition >= lineLength)
+            delayWritePosition = 0;
+    }
+}
+
+template void ShaperOversampler::processBypassed<float>(int, float*, float*, int) noexcept;
+template void ShaperOversampler::processBypassed<double>(int, double*, double*, int) noexcept;
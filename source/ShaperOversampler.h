@@ -0,0 +1,83 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Oversampling stage that runs only the drive shaper at 2x, 4x or 8x.
+//
+// Both tones travel as the two channels of one juce::dsp::Oversampling instance built
+// from half-band equiripple FIR stages with integer latency. Stage 0 means no
+// oversampling. Each stage also has a bypass path, used when the shaper produces
+// nothing that could alias. The bypass path delays the shaped tones by the same
+// latency, so the reported plugin latency does not change when the bypass engages.
+class ShaperOversampler
+{
+public:
+    static constexpr int numStages = 4;
+
+    ShaperOversampler();
+
+    void prepare(int maximumChunkSize);
+    void reset() noexcept;
+
+    // Fixed at construction, so any thread may read it.
+    int getLatencyInSamples(int stage) const noexcept { return latencies[static_cast<size_t>(stage)]; }
+
+    // Base-rate samples that must be fed through a stage to fully refill its filter state.
+    int getWarmUpLength(int stage) const noexcept { return 4 * getLatencyInSamples(stage) + 16; }
+
+    // Upsamples the base-rate sines in toneOne/toneTwo, applies shaper(data, count) to each
+    // oversampled channel and writes the downsampled result back in place. The filters run in
+    // double, so float tones pass through a double scratch copy and shaper always sees double.
+    template <typename SampleType, typename Shaper>
+    void processOversampled(int stage, SampleType* toneOne, SampleType* toneTwo, int numSamples, Shaper&& shaper)
+    {
+        double* channels[] = { nullptr, nullptr };
+
+        if constexpr (std::is_same_v<SampleType, double>)
+        {
+            channels[0] = toneOne;
+            channels[1] = toneTwo;
+        }
+        else
+        {
+            channels[0] = scratch[0].data();
+            channels[1] = scratch[1].data();
+            std::copy(toneOne, toneOne + numSamples, channels[0]);
+            std::copy(toneTwo, toneTwo + numSamples, channels[1]);
+        }
+
+        auto& oversampler = *oversamplers[static_cast<size_t>(stage)];
+        juce::dsp::AudioBlock<double> block(channels, 2, static_cast<size_t>(numSamples));
+
+        auto oversampled = oversampler.processSamplesUp(block);
+        const auto oversampledLength = static_cast<int>(oversampled.getNumSamples());
+        shaper(oversampled.getChannelPointer(0), oversampledLength);
+        shaper(oversampled.getChannelPointer(1), oversampledLength);
+
+        oversampler.processSamplesDown(block);
+
+        if constexpr (! std::is_same_v<SampleType, double>)
+        {
+            std::transform(channels[0], channels[0] + numSamples, toneOne, [](double x) { return static_cast<SampleType>(x); });
+            std::transform(channels[1], channels[1] + numSamples, toneTwo, [](double x) { return static_cast<SampleType>(x); });
+        }
+    }
+
+    // Delays already shaped tones by the stage latency so they line up with the oversampled path.
+    template <typename SampleType>
+    void processBypassed(int stage, SampleType* toneOne, SampleType* toneTwo, int numSamples) noexcept;
+
+private:
+    std::array<std::unique_ptr<juce::dsp::Oversampling<double>>, numStages> oversamplers;
+    std::array<int, numStages> latencies {};
+
+    std::array<std::vector<double>, 2> delayLines;
+    std::array<std::vector<double>, 2> scratch;
+    int delayWritePosition = 0;
+};
@@ -0,0 +1,129 @@
+#include "SineOscillator.h"
+
+#include "PrecisionPolicy.h"
+
+#include <cmath>
+#include <type_traits>
+
+void SineOscillator::reset(double initialPhase) noexcept
+{
+    phase = FixedPhase::fromRadians(initialPhase);
+}
+
+void SineOscillator::setPhaseIncrement(double radiansPerSample) noexcept
+{
+    const auto newStep = FixedPhase::fromRadians(radiansPerSample);
+
+    if (newStep == step && increment != 0.0)
+        return;
+
+    step = newStep;
+    increment = FixedPhase::toRadians(step);
+
+    for (int lane = 0; lane < maxLaneCount; ++lane)
+    {
+        laneOffsetRe[lane] = std::cos(increment * lane);
+        laneOffsetIm[lane] = std::sin(increment * lane);
+    }
+
+    stepRe = std::cos(increment * laneCount);
+    stepIm = std::sin(increment * laneCount);
+    wideStepRe = std::cos(increment * maxLaneCount);
+    wideStepIm = std::sin(increment * maxLaneCount);
+}
+
+void SineOscillator::advancePhase(int numSamples) noexcept
+{
+    phase = FixedPhase::advance(phase, step, static_cast<std::uint64_t>(numSamples));
+}
+
+template <typename SampleType>
+void SineOscillator::render(SampleType* dest, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    // Lanes run in the policy's kernel type; the seed and lane offsets are computed in double
+    // and rounded once, so a float render starts every call from an exact phase
+    using Real = typename PrecisionPolicy<SampleType>::Kernel;
+    constexpr auto renormaliseInterval = PrecisionPolicy<SampleType>::renormaliseInterval;
+    constexpr auto lanes = std::is_same_v<Real, float> ? maxLaneCount : laneCount;
+
+    alignas(64) Real re[lanes];
+    alignas(64) Real im[lanes];
+
+    const auto seedRe = std::cos(getPhase());
+    const auto seedIm = std::sin(getPhase());
+
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        re[lane] = static_cast<Real>(seedRe * laneOffsetRe[lane] - seedIm * laneOffsetIm[lane]);
+        im[lane] = static_cast<Real>(seedRe * laneOffsetIm[lane] + seedIm * laneOffsetRe[lane]);
+    }
+
+    const auto cr = static_cast<Real>(lanes == laneCount ? stepRe : wideStepRe);
+    const auto ci = static_cast<Real>(lanes == laneCount ? stepIm : wideStepIm);
+    const auto fullIterations = numSamples / lanes;
+
+    for (int iteration = 0; iteration < fullIterations; ++iteration)
+    {
+        auto* out = dest + iteration * lanes;
+
+        for (int lane = 0; lane < lanes; ++lane)
+            out[lane] = static_cast<SampleType>(im[lane]);
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const auto nextRe = re[lane] * cr - im[lane] * ci;
+            const auto nextIm = re[lane] * ci + im[lane] * cr;
+            re[lane] = nextRe;
+            im[lane] = nextIm;
+        }
+
+        if ((iteration + 1) % renormaliseInterval == 0)
+        {
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                // First-order Newton step towards |z| = 1; exact enough given how small the drift is.
+                const auto correction = Real(1.5) - Real(0.5) * (re[lane] * re[lane] + im[lane] * im[lane]);
+                re[lane] *= correction;
+                im[lane] *= correction;
+            }
+        }
+    }
+
+    const auto remaining = numSamples - fullIterations * lanes;
+    auto* tail = dest + fullIterations * lanes;
+
+    for (int lane = 0; lane < remaining; ++lane)
+        tail[lane] = static_cast<SampleType>(im[lane]);
+
+    advancePhase(numSamples);
+}
+
+template <typename SampleType>
+void SineOscillator::renderRamp(SampleType* dest, int numSamples, double targetIncrement) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    // The step sweep is a signed offset from the start step, added in the same modular arithmetic
+    const auto startStep = step;
+    const auto stepChange = static_cast<std::int64_t>(FixedPhase::fromRadians(targetIncrement) - startStep);
+    const auto stepChangePerSample = static_cast<double>(stepChange) / static_cast<double>(numSamples);
+    auto current = phase;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        dest[i] = static_cast<SampleType>(std::sin(FixedPhase::toRadians(current)));
+        current += startStep + static_cast<FixedPhase::Value>(static_cast<std::int64_t>(stepChangePerSample * static_cast<double>(i)));
+    }
+
+    phase = current;
+    setPhaseIncrement(targetIncrement);
+}
+
+template void SineOscillator::render<float>(float*, int) noexcept;
+template void SineOscillator::render<double>(double*, int) noexcept;
+template void SineOscillator::renderRamp<float>(float*, int, double) noexcept;
+template void SineOscillator::renderRamp<double>(double*, int, double) noexcept;
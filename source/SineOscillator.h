@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+#include "FixedPhase.h"
+
+// Sine oscillator that renders whole blocks with a complex-rotator recurrence.
+//
+// The rotator keeps one complex phasor per lane and advances all lanes by the same
+// rotation each iteration, so the inner loop is a fixed-width multiply-add that the
+// compiler maps onto SSE/AVX2/NEON registers. Every render call re-seeds the lanes
+// from the scalar phase accumulator, which keeps the output phase continuous across
+// blocks and stops rounding error in the recurrence from building up over time. The
+// accumulator itself is a 64-bit fixed-point phase (see FixedPhase), so it never drifts
+// and can jump to the exact state of any sample position in constant time.
+class SineOscillator
+{
+public:
+#if defined(__AVX512F__)
+    static constexpr int laneCount = 16;
+#elif defined(__AVX__)
+    static constexpr int laneCount = 8;
+#else
+    static constexpr int laneCount = 4;
+#endif
+
+    void reset(double initialPhase = 0.0) noexcept;
+
+    // The increment is quantised to the fixed-point step; getPhaseIncrement() returns the quantised value.
+    void setPhaseIncrement(double radiansPerSample) noexcept;
+
+    double getPhase() const noexcept { return FixedPhase::toRadians(phase); }
+    double getPhaseIncrement() const noexcept { return increment; }
+
+    FixedPhase::Value getFixedPhase() const noexcept { return phase; }
+    FixedPhase::Value getFixedStep() const noexcept { return step; }
+    void setFixedPhase(FixedPhase::Value newPhase) noexcept { phase = newPhase; }
+
+    // Puts the oscillator in exactly the state it would reach after sampleIndex samples at the
+    // current increment, starting from phaseAtSampleZero. Constant time for any index.
+    void seek(FixedPhase::Value phaseAtSampleZero, std::uint64_t sampleIndex) noexcept
+    {
+        phase = FixedPhase::advance(phaseAtSampleZero, step, sampleIndex);
+    }
+
+    // Writes numSamples of sin(phase) to dest and advances the phase accumulator.
+    template <typename SampleType>
+    void render(SampleType* dest, int numSamples) noexcept;
+
+    // Like render(), but sweeps the increment linearly to targetIncrement over the block. This
+    // path evaluates sin() per sample and is only used while the frequency is being smoothed.
+    template <typename SampleType>
+    void renderRamp(SampleType* dest, int numSamples, double targetIncrement) noexcept;
+
+private:
+    void advancePhase(int numSamples) noexcept;
+
+    FixedPhase::Value phase = 0;
+    FixedPhase::Value step = 0;
+    double increment = 0.0;
+
+    // Float kernels fit twice as many lanes in the same registers.
+    static constexpr int maxLaneCount = 2 * laneCount;
+
+    // Per-lane offsets e^(i * k * increment) and the per-iteration rotations e^(i * lanes * increment)
+    // for the double (laneCount) and float (maxLaneCount) kernels.
+    alignas(64) double laneOffsetRe[maxLaneCount] {};
+    alignas(64) double laneOffsetIm[maxLaneCount] {};
+    double stepRe = 1.0;
+    double stepIm = 0.0;
+    double wideStepRe = 1.0;
+    double wideStepIm = 0.0;
+};
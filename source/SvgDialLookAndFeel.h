@@ -2,11 +2,15 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 
+#include "KnobImageAtlas.h"
+
+// Rotary dial drawn from an SVG knob over an arc track. The dial layers are rasterised once per
+// size and display scale by a KnobImageAtlas, usually the one EditorAssets shares between all
+// editors, so dragging a knob only blits images.
 class SvgDialLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    SvgDialLookAndFeel(const void* svgData,
-                       size_t svgSize,
+    SvgDialLookAndFeel(KnobImageAtlas& knobAtlas,
                        juce::Colour trackColour,
                        juce::Colour outlineColour);
 
@@ -21,5 +25,5 @@ public:
                           juce::Slider& slider) override;
 
 private:
-    std::unique_ptr<juce::Drawable> knobDrawable;
+    KnobImageAtlas& atlas;
 };
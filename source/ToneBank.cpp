@@ -0,0 +1,261 @@
+#include "ToneBank.h"
+
+#include <cmath>
+#include <iterator>
+
+ToneBankLayout ToneBankLayout::dualTone(double spreadHz, double levelOne, double levelTwo, double panOne, double panTwo) noexcept
+{
+    ToneBankLayout layout;
+    layout.numPartials = 2;
+    layout.offsetsHz[0] = -spreadHz;
+    layout.offsetsHz[1] = spreadHz;
+    layout.levels[0] = levelOne;
+    layout.levels[1] = levelTwo;
+    layout.pans[0] = panOne;
+    layout.pans[1] = panTwo;
+    return layout;
+}
+
+void ToneBank::setTargets(const ToneBankLayout& layout, const ChannelPanner& panner) noexcept
+{
+    const auto newCount = std::clamp(layout.numPartials, 0, maxPartials);
+
+    // Partials that start now begin silent, at their own offset and phase zero
+    for (int partial = numPartials; partial < newCount; ++partial)
+    {
+        phases[partial] = 0;
+        offsetsHz[partial] = layout.offsetsHz[partial];
+
+        for (int channel = 0; channel < ChannelPanner::maxChannels; ++channel)
+            channelWeights[channel * maxPartials + partial] = 0.0;
+    }
+
+    targetNumPartials = newCount;
+    numPartials = std::max(numPartials, newCount);
+
+    for (int partial = 0; partial < numPartials; ++partial)
+    {
+        const auto kept = partial < newCount;
+        targetOffsetsHz[partial] = kept ? layout.offsetsHz[partial] : offsetsHz[partial];
+        levels[partial] = kept ? layout.levels[partial] : 0.0;
+        pans[partial] = kept ? layout.pans[partial] : pans[partial];
+    }
+
+    updateTargetWeights(panner);
+}
+
+void ToneBank::setLayout(const ToneBankLayout& layout, const ChannelPanner& panner) noexcept
+{
+    setTargets(layout, panner);
+
+    if (rampLength <= 0)
+    {
+        finishRamp();
+        return;
+    }
+
+    rampRemaining = rampLength;
+    const auto length = static_cast<double>(rampLength);
+
+    for (int partial = 0; partial < numPartials; ++partial)
+        offsetSteps[partial] = (targetOffsetsHz[partial] - offsetsHz[partial]) / length;
+
+    for (int channel = 0; channel < numWeightedChannels; ++channel)
+    {
+        for (int partial = 0; partial < numPartials; ++partial)
+        {
+            const auto index = channel * maxPartials + partial;
+            channelWeightSteps[index] = (targetChannelWeights[index] - channelWeights[index]) / length;
+        }
+    }
+}
+
+void ToneBank::jumpToLayout(const ToneBankLayout& layout, const ChannelPanner& panner) noexcept
+{
+    setTargets(layout, panner);
+    finishRamp();
+}
+
+void ToneBank::finishRamp() noexcept
+{
+    rampRemaining = 0;
+    numPartials = targetNumPartials;
+    std::copy(targetOffsetsHz, targetOffsetsHz + numPartials, offsetsHz);
+    std::copy(std::begin(targetChannelWeights), std::end(targetChannelWeights), channelWeights);
+    updateIncrements();
+}
+
+void ToneBank::advanceRamp(int numSamples) noexcept
+{
+    rampRemaining -= numSamples;
+
+    if (rampRemaining <= 0)
+    {
+        finishRamp();
+        return;
+    }
+
+    const auto samples = static_cast<double>(numSamples);
+
+    for (int partial = 0; partial < numPartials; ++partial)
+        offsetsHz[partial] += offsetSteps[partial] * samples;
+
+    for (int channel = 0; channel < numWeightedChannels; ++channel)
+    {
+        for (int partial = 0; partial < numPartials; ++partial)
+        {
+            const auto index = channel * maxPartials + partial;
+            channelWeights[index] += channelWeightSteps[index] * samples;
+        }
+    }
+
+    updateIncrements();
+}
+
+void ToneBank::reset() noexcept
+{
+    std::fill(phases, phases + maxPartials, FixedPhase::Value {});
+}
+
+void ToneBank::seek(std::int64_t samplePosition) noexcept
+{
+    for (int partial = 0; partial < numPartials; ++partial)
+        phases[partial] = FixedPhase::advance(0, steps[partial], static_cast<std::uint64_t>(samplePosition));
+}
+
+void ToneBank::setCenterFrequency(double centerHz, double newSampleRate) noexcept
+{
+    if (centerHz == centerFrequency && newSampleRate == sampleRate)
+        return;
+
+    centerFrequency = centerHz;
+    sampleRate = newSampleRate;
+    updateIncrements();
+}
+
+double ToneBank::getHighestFrequency() const noexcept
+{
+    auto highest = 0.0;
+
+    for (int partial = 0; partial < numPartials; ++partial)
+        highest = std::max(highest, centerFrequency + offsetsHz[partial]);
+
+    return highest;
+}
+
+void ToneBank::updateTargetWeights(const ChannelPanner& panner) noexcept
+{
+    numWeightedChannels = panner.getNumChannels();
+    double panGains[ChannelPanner::maxChannels];
+
+    for (int partial = 0; partial < numPartials; ++partial)
+    {
+        panner.computeGains(pans[partial], panGains);
+
+        for (int channel = 0; channel < numWeightedChannels; ++channel)
+            targetChannelWeights[channel * maxPartials + partial] = levels[partial] * panGains[channel];
+    }
+}
+
+void ToneBank::updateChannelGains(const ChannelPanner& panner) noexcept
+{
+    updateTargetWeights(panner);
+    finishRamp();
+}
+
+void ToneBank::updateIncrements() noexcept
+{
+    if (sampleRate <= 0.0)
+        return;
+
+    for (int partial = 0; partial < numPartials; ++partial)
+    {
+        steps[partial] = FixedPhase::fromCycles(std::max(0.0, centerFrequency + offsetsHz[partial]) / sampleRate);
+        const auto increment = FixedPhase::toRadians(steps[partial]);
+        rotationRe[partial] = std::cos(increment);
+        rotationIm[partial] = std::sin(increment);
+    }
+}
+
+void ToneBank::renderSines(int numSamples) noexcept
+{
+    const auto count = numPartials;
+
+    // Re-seeded from the scalar phases every sub-block, so the rotators need no renormalisation
+    alignas(64) double re[maxPartials];
+    alignas(64) double im[maxPartials];
+
+    for (int partial = 0; partial < count; ++partial)
+    {
+        const auto phase = FixedPhase::toRadians(phases[partial]);
+        re[partial] = std::cos(phase);
+        im[partial] = std::sin(phase);
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int partial = 0; partial < count; ++partial)
+        {
+            sines[partial * subBlockSize + i] = im[partial];
+
+            const auto nextRe = re[partial] * rotationRe[partial] - im[partial] * rotationIm[partial];
+            im[partial] = re[partial] * rotationIm[partial] + im[partial] * rotationRe[partial];
+            re[partial] = nextRe;
+        }
+    }
+
+    for (int partial = 0; partial < count; ++partial)
+        phases[partial] = FixedPhase::advance(phases[partial], steps[partial], static_cast<std::uint64_t>(numSamples));
+}
+
+template <typename SampleType>
+void ToneBank::mixToChannels(SampleType* const* outputs,
+                             int outputOffset,
+                             int numChannels,
+                             int numSamples,
+                             double gain,
+                             double gainStep,
+                             bool rampWeights) const noexcept
+{
+    const auto count = numPartials;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* output = outputs[channel] + outputOffset;
+
+        if (channel >= numWeightedChannels)
+        {
+            std::fill(output, output + numSamples, SampleType {});
+            continue;
+        }
+
+        const auto* weights = channelWeights + channel * maxPartials;
+        const auto* weightSteps = channelWeightSteps + channel * maxPartials;
+        double sum[subBlockSize] {};
+
+        for (int partial = 0; partial < count; ++partial)
+        {
+            const auto weight = weights[partial];
+            const auto* partialSines = sines + partial * subBlockSize;
+
+            if (rampWeights)
+            {
+                const auto weightStep = weightSteps[partial];
+
+                for (int i = 0; i < numSamples; ++i)
+                    sum[i] += (weight + weightStep * static_cast<double>(i)) * partialSines[i];
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    sum[i] += weight * partialSines[i];
+            }
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = static_cast<SampleType>(sum[i] * (gain + gainStep * static_cast<double>(i)));
+    }
+}
+
+template void ToneBank::mixToChannels<float>(float* const*, int, int, int, double, double, bool) const noexcept;
+template void ToneBank::mixToChannels<double>(double* const*, int, int, int, double, double, bool) const noexcept;
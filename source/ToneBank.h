@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "ChannelPanner.h"
+#include "FixedPhase.h"
+
+// Partial layout of a tone bank: a frequency offset from the center, a linear level and a
+// pan position per partial. Published to the audio thread as a whole; see ToneBank.
+struct ToneBankLayout
+{
+    static constexpr int maxPartials = 64;
+
+    // Zero partials means no bank: the processor plays the Center/Spread tone pair instead.
+    int numPartials = 0;
+
+    // Bumped by whoever publishes a new layout so the audio thread can tell it apart from the last one.
+    std::uint32_t revision = 0;
+
+    double offsetsHz[maxPartials] {};
+    double levels[maxPartials] {};
+    double pans[maxPartials] {};
+
+    // The Center/Spread controls expressed as a bank: two partials at minus and plus the spread.
+    static ToneBankLayout dualTone(double spreadHz, double levelOne, double levelTwo, double panOne, double panTwo) noexcept;
+};
+
+// Renders any number of partials around a shared center frequency, each shaped on its own.
+//
+// Partial state is kept in structure-of-arrays form. Per sample, the rotator kernel advances
+// all partials in one loop over contiguous arrays, and the channel mix is one dot product per
+// channel against precomputed level-times-pan weights. Work grows linearly with the partial
+// count. The working set of one sub-block stays within a typical L1 cache even with all 64
+// partials.
+class ToneBank
+{
+public:
+    static constexpr int maxPartials = ToneBankLayout::maxPartials;
+
+    // Length of the glide between layouts; zero switches at once.
+    void setRampLength(int numSamples) noexcept { rampLength = numSamples; }
+
+    // Glides to a new layout over the ramp length, like a parameter change. Partials that exist
+    // in both layouts keep their phase and move to their new offset, level and pan. New partials
+    // fade in at their own offset and partials the new layout drops fade out. The panner gives
+    // the channel gains of the new pans.
+    void setLayout(const ToneBankLayout& layout, const ChannelPanner& panner) noexcept;
+
+    // Switches to a layout at once, with no glide.
+    void jumpToLayout(const ToneBankLayout& layout, const ChannelPanner& panner) noexcept;
+
+    // Lands on the target of the current glide straight away.
+    void finishRamp() noexcept;
+    bool isRamping() const noexcept { return rampRemaining > 0; }
+
+    void reset() noexcept;
+
+    // Sets every partial to the phase it reaches samplePosition samples after phase zero at the current center.
+    void seek(std::int64_t samplePosition) noexcept;
+
+    // Partials being rendered, including any still fading out.
+    int getNumPartials() const noexcept { return numPartials; }
+
+    FixedPhase::Value getPhase(int partial) const noexcept { return phases[partial]; }
+    void setPhase(int partial, FixedPhase::Value phase) noexcept { phases[partial] = phase; }
+
+    void setCenterFrequency(double centerHz, double sampleRate) noexcept;
+    double getHighestFrequency() const noexcept;
+
+    // Recomputes the per-channel weights for a new channel layout. Finishes any glide first, as
+    // the old weights do not carry over to other speakers.
+    void updateChannelGains(const ChannelPanner& panner) noexcept;
+
+    // Overwrites numChannels output channels. The overall gain moves linearly from gainStart to
+    // gainEnd over numSamples. shape(double* data, int count) rewrites a block of sines in place.
+    template <typename SampleType, typename Shaper>
+    void render(SampleType* const* outputs,
+                int numChannels,
+                int numSamples,
+                double gainStart,
+                double gainEnd,
+                Shaper&& shape) noexcept
+    {
+        const auto gainStep = (gainEnd - gainStart) / static_cast<double>(numSamples);
+
+        for (int start = 0; start < numSamples;)
+        {
+            // A glide ends on a sub-block boundary, so its length does not depend on the host's blocks
+            const auto ramping = isRamping();
+            const auto count = std::min({ subBlockSize, numSamples - start, ramping ? rampRemaining : subBlockSize });
+
+            renderSines(count);
+
+            for (int partial = 0; partial < numPartials; ++partial)
+                shape(sines + partial * subBlockSize, count);
+
+            mixToChannels(outputs, start, numChannels, count, gainStart + gainStep * static_cast<double>(start), gainStep, ramping);
+
+            if (ramping)
+                advanceRamp(count);
+
+            start += count;
+        }
+    }
+
+private:
+    static constexpr int subBlockSize = 64;
+
+    // Sets the targets of a glide to the layout, adding the partials it starts at zero level.
+    void setTargets(const ToneBankLayout& layout, const ChannelPanner& panner) noexcept;
+    void updateTargetWeights(const ChannelPanner& panner) noexcept;
+    void advanceRamp(int numSamples) noexcept;
+
+    void updateIncrements() noexcept;
+    void renderSines(int numSamples) noexcept;
+
+    template <typename SampleType>
+    void mixToChannels(SampleType* const* outputs,
+                       int outputOffset,
+                       int numChannels,
+                       int numSamples,
+                       double gain,
+                       double gainStep,
+                       bool rampWeights) const noexcept;
+
+    int numPartials = 0;
+    int targetNumPartials = 0;
+    double centerFrequency = 0.0;
+    double sampleRate = 0.0;
+
+    int rampLength = 0;
+    int rampRemaining = 0;
+
+    // Offsets and weights move from their current values to their targets in equal steps per sample.
+    double offsetsHz[maxPartials] {};
+    double targetOffsetsHz[maxPartials] {};
+    double offsetSteps[maxPartials] {};
+    double levels[maxPartials] {};
+    double pans[maxPartials] {};
+
+    FixedPhase::Value phases[maxPartials] {};
+    FixedPhase::Value steps[maxPartials] {};
+    double rotationRe[maxPartials] {};
+    double rotationIm[maxPartials] {};
+
+    // level * pan gain, channel-major so each channel's weights are contiguous.
+    alignas(64) double channelWeights[ChannelPanner::maxChannels * maxPartials] {};
+    alignas(64) double targetChannelWeights[ChannelPanner::maxChannels * maxPartials] {};
+    alignas(64) double channelWeightSteps[ChannelPanner::maxChannels * maxPartials] {};
+    int numWeightedChannels = 0;
+
+    // Sines for one sub-block, partial-major, so each partial is shaped and mixed as one contiguous run.
+    alignas(64) double sines[subBlockSize * maxPartials] {};
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "WaveshaperTable.h"
+
+#include <cmath>
+
+// Compile-time specialised inner loops for the per-block tone pipeline.
+//
+// Every setting that stays fixed for a whole block is a template parameter here rather
+// than a branch inside the sample loop. The select functions run once per block and
+// return the cheapest instantiation for the current configuration, so the loops that
+// run per sample carry no branches and no math for inactive features. Tone buffers are
+// typed by the PrecisionPolicy kernel type, so float blocks never widen to double.
+namespace ToneKernels
+{
+enum class ShapeKind
+{
+    tanhOnly,
+    atanOnly,
+    blend
+};
+
+template <ShapeKind kind, typename Real>
+void shapeExact(const WaveshaperCurve& curve, Real* data, int numSamples) noexcept
+{
+    const auto drive = static_cast<Real>(curve.driveAmount);
+    const auto tanhScale = static_cast<Real>(curve.tanhScale);
+    const auto atanScale = static_cast<Real>(curve.atanScale);
+    const auto tanhWeight = static_cast<Real>((1.0 - curve.typeMix) * curve.tanhScale);
+    const auto atanWeight = static_cast<Real>(curve.typeMix * curve.atanScale);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto driven = data[i] * drive;
+
+        if constexpr (kind == ShapeKind::tanhOnly)
+            data[i] = std::tanh(driven) * tanhScale;
+        else if constexpr (kind == ShapeKind::atanOnly)
+            data[i] = std::atan(driven) * atanScale;
+        else
+            data[i] = tanhWeight * std::tanh(driven) + atanWeight * std::atan(driven);
+    }
+}
+
+template <typename Real>
+using ExactShaper = void (*)(const WaveshaperCurve&, Real*, int) noexcept;
+
+template <typename Real>
+ExactShaper<Real> selectExactShaper(const WaveshaperCurve& curve) noexcept
+{
+    if (curve.typeMix <= 0.0)
+        return shapeExact<ShapeKind::tanhOnly, Real>;
+    if (curve.typeMix >= 1.0)
+        return shapeExact<ShapeKind::atanOnly, Real>;
+
+    return shapeExact<ShapeKind::blend, Real>;
+}
+
+// Shapes a block while drive or type is being smoothed. Sample i crossfades linearly from the
+// block's starting curve to its ending curve with weight i / numSamples, so consecutive blocks
+// join up without a step in the transfer function.
+template <typename Real>
+void shapeExactCrossfade(const WaveshaperCurve& from, const WaveshaperCurve& to, Real* data, int numSamples) noexcept
+{
+    const auto fadeStep = 1.0 / static_cast<double>(numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto start = from.evaluate(static_cast<double>(data[i]));
+        const auto end = to.evaluate(static_cast<double>(data[i]));
+        data[i] = static_cast<Real>(start + (end - start) * (fadeStep * static_cast<double>(i)));
+    }
+}
+
+// Shapes a block partway between two morph states: sample i is the from table's output
+// crossfaded towards the to table's, with the weight moving linearly from weightStart to
+// weightEnd. Both tables are plain lookups, so this costs no transcendental per sample.
+template <typename Real>
+void shapeTableCrossfade(const WaveshaperTable& from,
+                         const WaveshaperTable& to,
+                         double weightStart,
+                         double weightEnd,
+                         Real* data,
+                         int numSamples) noexcept
+{
+    const auto weightStep = (weightEnd - weightStart) / static_cast<double>(numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto start = static_cast<double>(from.lookup(data[i]));
+        const auto end = static_cast<double>(to.lookup(data[i]));
+        data[i] = static_cast<Real>(start + (end - start) * (weightStart + weightStep * static_cast<double>(i)));
+    }
+}
+
+// The harmonic shaping mode's counterpart of shapeTableCrossfade: both series resynthesise the
+// tone with the same number of harmonics, and the results are crossfaded the same way.
+template <typename Real>
+void renderHarmonicsCrossfade(const HarmonicSeries& from,
+                              const HarmonicSeries& to,
+                              int numOddHarmonics,
+                              double weightStart,
+                              double weightEnd,
+                              Real* data,
+                              int numSamples) noexcept
+{
+    constexpr int pieceSize = 256;
+    Real shapedFrom[pieceSize];
+    const auto weightStep = (weightEnd - weightStart) / static_cast<double>(numSamples);
+
+    for (int pieceStart = 0; pieceStart < numSamples; pieceStart += pieceSize)
+    {
+        const auto count = numSamples - pieceStart < pieceSize ? numSamples - pieceStart : pieceSize;
+        auto* piece = data + pieceStart;
+
+        from.render(piece, shapedFrom, count, numOddHarmonics);
+        to.render(piece, piece, count, numOddHarmonics);
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto weight = weightStart + weightStep * static_cast<double>(pieceStart + i);
+            piece[i] = static_cast<Real>(shapedFrom[i] + (piece[i] - shapedFrom[i]) * weight);
+        }
+    }
+}
+
+// Writes one output channel as gainOne * toneOne + gainTwo * toneTwo. Tone gain, attenuation
+// and pan are already folded into the two gains, so no instantiation multiplies by an
+// attenuation that happens to be unity. With identicalTones both oscillators share frequency
+// and phase, toneTwo is never read and the two gains collapse into one.
+template <typename SampleType, bool identicalTones, typename Real>
+void mixTonesToChannel(const Real* toneOne,
+                       const Real* toneTwo,
+                       double gainOne,
+                       double gainTwo,
+                       SampleType* output,
+                       int numSamples) noexcept
+{
+    if constexpr (identicalTones)
+    {
+        const auto gain = static_cast<Real>(gainOne + gainTwo);
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = static_cast<SampleType>(toneOne[i] * gain);
+    }
+    else
+    {
+        const auto one = static_cast<Real>(gainOne);
+        const auto two = static_cast<Real>(gainTwo);
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = static_cast<SampleType>(toneOne[i] * one + toneTwo[i] * two);
+    }
+}
+
+template <typename SampleType, typename Real>
+using ChannelMixer = void (*)(const Real*, const Real*, double, double, SampleType*, int) noexcept;
+
+template <typename SampleType, typename Real>
+ChannelMixer<SampleType, Real> selectChannelMixer(bool identicalTones) noexcept
+{
+    return identicalTones ? mixTonesToChannel<SampleType, true, Real> : mixTonesToChannel<SampleType, false, Real>;
+}
+
+// Ramping counterpart of mixTonesToChannel for channels whose gain or pan is being smoothed.
+// Each gain moves linearly from its start value and reaches its end value one sample past the
+// block, where the next block picks it up.
+template <typename SampleType, typename Real>
+void mixTonesToChannelRamp(const Real* toneOne,
+                           const Real* toneTwo,
+                           double gainOneStart,
+                           double gainOneEnd,
+                           double gainTwoStart,
+                           double gainTwoEnd,
+                           SampleType* output,
+                           int numSamples) noexcept
+{
+    const auto gainOneStep = static_cast<Real>((gainOneEnd - gainOneStart) / static_cast<double>(numSamples));
+    const auto gainTwoStep = static_cast<Real>((gainTwoEnd - gainTwoStart) / static_cast<double>(numSamples));
+    const auto startOne = static_cast<Real>(gainOneStart);
+    const auto startTwo = static_cast<Real>(gainTwoStart);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto position = static_cast<Real>(i);
+        output[i] = static_cast<SampleType>(toneOne[i] * (startOne + gainOneStep * position)
+                                            + toneTwo[i] * (startTwo + gainTwoStep * position));
+    }
+}
+} // namespace ToneKernels
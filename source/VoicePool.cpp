@@ -0,0 +1,235 @@
+#include "VoicePool.h"
+
+#include <cmath>
+#include <utility>
+
+namespace
+{
+constexpr double attackSeconds = 0.005;
+constexpr double releaseSeconds = 0.05;
+
+inline double getNoteFrequency(int noteNumber) noexcept
+{
+    return 440.0 * std::pow(2.0, static_cast<double>(noteNumber - 69) / 12.0);
+}
+} // namespace
+
+void VoicePool::prepare(double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate;
+    attackStep = 1.0 / std::max(1.0, attackSeconds * sampleRate);
+    releaseStep = 1.0 / std::max(1.0, releaseSeconds * sampleRate);
+
+    for (int slot = 0; slot < numActive; ++slot)
+        updateIncrements(slot);
+}
+
+void VoicePool::reset() noexcept
+{
+    numActive = 0;
+}
+
+void VoicePool::noteOn(int noteNumber, float velocity) noexcept
+{
+    for (int slot = 0; slot < numActive; ++slot)
+    {
+        if (noteNumbers[slot] == noteNumber)
+        {
+            // Retriggered notes keep their phase and attack from wherever the envelope is
+            velocities[slot] = static_cast<double>(velocity);
+            levelSteps[slot] = attackStep;
+            startOrders[slot] = nextStartOrder++;
+            return;
+        }
+    }
+
+    if (numActive < maxVoices)
+    {
+        startVoice(numActive++, noteNumber, velocity);
+        return;
+    }
+
+    // Steal the oldest voice; its level carries over so the new note attacks from there
+    auto oldest = 0;
+    for (int slot = 1; slot < numActive; ++slot)
+        if (startOrders[slot] < startOrders[oldest])
+            oldest = slot;
+
+    const auto level = levels[oldest];
+    startVoice(oldest, noteNumber, velocity);
+    levels[oldest] = level;
+}
+
+void VoicePool::noteOff(int noteNumber) noexcept
+{
+    for (int slot = 0; slot < numActive; ++slot)
+        if (noteNumbers[slot] == noteNumber)
+            levelSteps[slot] = -releaseStep;
+}
+
+void VoicePool::releaseAll() noexcept
+{
+    for (int slot = 0; slot < numActive; ++slot)
+        levelSteps[slot] = -releaseStep;
+}
+
+void VoicePool::setSpread(double spreadHz) noexcept
+{
+    if (spreadHz == spread)
+        return;
+
+    spread = spreadHz;
+
+    for (int slot = 0; slot < numActive; ++slot)
+        updateIncrements(slot);
+}
+
+double VoicePool::getHighestFrequency() const noexcept
+{
+    auto highest = 0.0;
+
+    for (int slot = 0; slot < numActive; ++slot)
+        highest = std::max(highest, noteFrequencies[slot] + spread);
+
+    return highest;
+}
+
+void VoicePool::startVoice(int slot, int noteNumber, float velocity) noexcept
+{
+    noteNumbers[slot] = noteNumber;
+    startOrders[slot] = nextStartOrder++;
+    noteFrequencies[slot] = getNoteFrequency(noteNumber);
+    velocities[slot] = static_cast<double>(velocity);
+    levels[slot] = 0.0;
+    levelSteps[slot] = attackStep;
+    phasesLow[slot] = 0;
+    phasesHigh[slot] = 0;
+    updateIncrements(slot);
+}
+
+void VoicePool::updateIncrements(int slot) noexcept
+{
+    stepsLow[slot] = FixedPhase::fromCycles(std::max(0.0, noteFrequencies[slot] - spread) / sampleRate);
+    stepsHigh[slot] = FixedPhase::fromCycles(std::max(0.0, noteFrequencies[slot] + spread) / sampleRate);
+    const auto incrementLow = FixedPhase::toRadians(stepsLow[slot]);
+    const auto incrementHigh = FixedPhase::toRadians(stepsHigh[slot]);
+    rotationReLow[slot] = std::cos(incrementLow);
+    rotationImLow[slot] = std::sin(incrementLow);
+    rotationReHigh[slot] = std::cos(incrementHigh);
+    rotationImHigh[slot] = std::sin(incrementHigh);
+}
+
+void VoicePool::removeVoice(int slot) noexcept
+{
+    const auto last = --numActive;
+
+    if (slot == last)
+        return;
+
+    noteNumbers[slot] = noteNumbers[last];
+    startOrders[slot] = startOrders[last];
+    noteFrequencies[slot] = noteFrequencies[last];
+    velocities[slot] = velocities[last];
+    levels[slot] = levels[last];
+    levelSteps[slot] = levelSteps[last];
+    phasesLow[slot] = phasesLow[last];
+    phasesHigh[slot] = phasesHigh[last];
+    stepsLow[slot] = stepsLow[last];
+    stepsHigh[slot] = stepsHigh[last];
+    rotationReLow[slot] = rotationReLow[last];
+    rotationImLow[slot] = rotationImLow[last];
+    rotationReHigh[slot] = rotationReHigh[last];
+    rotationImHigh[slot] = rotationImHigh[last];
+}
+
+void VoicePool::renderSines(int numSamples) noexcept
+{
+    const auto numVoices = numActive;
+    auto* low = sines;
+    auto* high = sines + numSamples * numVoices;
+
+    // Phasors are re-seeded from the scalar phases every sub-block, which is short enough
+    // that the rotator needs no renormalisation in between
+    alignas(64) double reLow[maxVoices];
+    alignas(64) double imLow[maxVoices];
+    alignas(64) double reHigh[maxVoices];
+    alignas(64) double imHigh[maxVoices];
+
+    for (int voice = 0; voice < numVoices; ++voice)
+    {
+        const auto phaseLow = FixedPhase::toRadians(phasesLow[voice]);
+        const auto phaseHigh = FixedPhase::toRadians(phasesHigh[voice]);
+        reLow[voice] = std::cos(phaseLow);
+        imLow[voice] = std::sin(phaseLow);
+        reHigh[voice] = std::cos(phaseHigh);
+        imHigh[voice] = std::sin(phaseHigh);
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto* lowRow = low + i * numVoices;
+        auto* highRow = high + i * numVoices;
+
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            lowRow[voice] = imLow[voice];
+            highRow[voice] = imHigh[voice];
+
+            const auto nextReLow = reLow[voice] * rotationReLow[voice] - imLow[voice] * rotationImLow[voice];
+            imLow[voice] = reLow[voice] * rotationImLow[voice] + imLow[voice] * rotationReLow[voice];
+            reLow[voice] = nextReLow;
+
+            const auto nextReHigh = reHigh[voice] * rotationReHigh[voice] - imHigh[voice] * rotationImHigh[voice];
+            imHigh[voice] = reHigh[voice] * rotationImHigh[voice] + imHigh[voice] * rotationReHigh[voice];
+            reHigh[voice] = nextReHigh;
+        }
+    }
+
+    for (int voice = 0; voice < numVoices; ++voice)
+    {
+        phasesLow[voice] = FixedPhase::advance(phasesLow[voice], stepsLow[voice], static_cast<std::uint64_t>(numSamples));
+        phasesHigh[voice] = FixedPhase::advance(phasesHigh[voice], stepsHigh[voice], static_cast<std::uint64_t>(numSamples));
+    }
+}
+
+template <typename SampleType>
+void VoicePool::mixVoices(SampleType* toneOne, SampleType* toneTwo, int numSamples) noexcept
+{
+    const auto numVoices = numActive;
+    const auto* low = sines;
+    const auto* high = sines + numSamples * numVoices;
+
+    alignas(64) double weights[maxVoices];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto* lowRow = low + i * numVoices;
+        const auto* highRow = high + i * numVoices;
+
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            levels[voice] = std::clamp(levels[voice] + levelSteps[voice], 0.0, 1.0);
+            weights[voice] = levels[voice] * velocities[voice];
+        }
+
+        auto sumLow = 0.0;
+        auto sumHigh = 0.0;
+
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            sumLow += weights[voice] * lowRow[voice];
+            sumHigh += weights[voice] * highRow[voice];
+        }
+
+        toneOne[i] = static_cast<SampleType>(sumLow);
+        toneTwo[i] = static_cast<SampleType>(sumHigh);
+    }
+
+    // Released voices that have faded out go back to the pool
+    for (int slot = numActive - 1; slot >= 0; --slot)
+        if (levelSteps[slot] < 0.0 && levels[slot] <= 0.0)
+            removeVoice(slot);
+}
+
+template void VoicePool::mixVoices<float>(float*, float*, int) noexcept;
+template void VoicePool::mixVoices<double>(double*, double*, int) noexcept;
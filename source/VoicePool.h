@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "FixedPhase.h"
+
+// Fixed pool of dual-tone voices driven by MIDI notes.
+//
+// Each voice plays two tones at its note frequency minus and plus the spread, like the
+// drone tones around the center frequency. Voice state lives in structure-of-arrays form
+// with the active voices packed at the front, so the oscillator kernel runs every voice
+// in one vectorisable loop per sample instead of one voice after another. Every array is
+// allocated with the pool; note events and rendering never allocate.
+class VoicePool
+{
+public:
+    static constexpr int maxVoices = 32;
+
+    void prepare(double sampleRate) noexcept;
+    void reset() noexcept;
+
+    void noteOn(int noteNumber, float velocity) noexcept;
+    void noteOff(int noteNumber) noexcept;
+    void releaseAll() noexcept;
+    void setSpread(double spreadHz) noexcept;
+
+    int getNumActiveVoices() const noexcept { return numActive; }
+    double getHighestFrequency() const noexcept;
+
+    // Sums every voice's low tone into toneOne and high tone into toneTwo, each voice shaped on
+    // its own first. shape(double* data, int count) rewrites a block of sines in place.
+    template <typename SampleType, typename Shaper>
+    void render(SampleType* toneOne, SampleType* toneTwo, int numSamples, Shaper&& shape) noexcept
+    {
+        for (int start = 0; start < numSamples; start += subBlockSize)
+        {
+            const auto count = std::min(subBlockSize, numSamples - start);
+
+            if (numActive == 0)
+            {
+                std::fill(toneOne + start, toneOne + start + count, SampleType {});
+                std::fill(toneTwo + start, toneTwo + start + count, SampleType {});
+                continue;
+            }
+
+            renderSines(count);
+            shape(sines, count * numActive);
+            shape(sines + count * numActive, count * numActive);
+            mixVoices(toneOne + start, toneTwo + start, count);
+        }
+    }
+
+private:
+    static constexpr int subBlockSize = 64;
+
+    void renderSines(int numSamples) noexcept;
+    template <typename SampleType>
+    void mixVoices(SampleType* toneOne, SampleType* toneTwo, int numSamples) noexcept;
+    void startVoice(int slot, int noteNumber, float velocity) noexcept;
+    void updateIncrements(int slot) noexcept;
+    void removeVoice(int slot) noexcept;
+
+    double sampleRate = 44100.0;
+    double spread = 0.0;
+    double attackStep = 1.0;
+    double releaseStep = 1.0;
+    int numActive = 0;
+    std::uint64_t nextStartOrder = 0;
+
+    int noteNumbers[maxVoices] {};
+    std::uint64_t startOrders[maxVoices] {};
+    double noteFrequencies[maxVoices] {};
+    double velocities[maxVoices] {};
+
+    // Envelope level in [0, 1] and its per-sample change; a negative step means the voice is releasing.
+    double levels[maxVoices] {};
+    double levelSteps[maxVoices] {};
+
+    FixedPhase::Value phasesLow[maxVoices] {};
+    FixedPhase::Value phasesHigh[maxVoices] {};
+    FixedPhase::Value stepsLow[maxVoices] {};
+    FixedPhase::Value stepsHigh[maxVoices] {};
+    double rotationReLow[maxVoices] {};
+    double rotationImLow[maxVoices] {};
+    double rotationReHigh[maxVoices] {};
+    double rotationImHigh[maxVoices] {};
+
+    // Sines for one sub-block, sample-major: all low tones for sample 0, then sample 1, ...,
+    // followed by the high tones in the same order.
+    alignas(64) double sines[2 * subBlockSize * maxVoices] {};
+};
@@ -0,0 +1,55 @@
+#include "WaveshaperTable.h"
+
+#include <cmath>
+
+WaveshaperCurve WaveshaperCurve::fromParameters(float driveDb, float shapeType) noexcept
+{
+    WaveshaperCurve curve;
+    curve.driveDb = driveDb;
+    curve.shapeType = shapeType;
+    curve.driveAmount = std::pow(10.0, static_cast<double>(driveDb) / 20.0);
+
+    const auto tanhDenominator = std::tanh(curve.driveAmount);
+    curve.tanhScale = tanhDenominator != 0.0 ? (1.0 / tanhDenominator) : 1.0;
+    const auto atanDenominator = std::atan(curve.driveAmount);
+    curve.atanScale = atanDenominator != 0.0 ? (1.0 / atanDenominator) : 1.0;
+
+    const auto clippedType = shapeType < 0.0f ? 0.0f : (shapeType > 1.0f ? 1.0f : shapeType);
+    curve.typeMix = static_cast<double>(clippedType);
+    return curve;
+}
+
+double WaveshaperCurve::evaluate(double x) const noexcept
+{
+    const auto driven = x * driveAmount;
+
+    // Skip the curve that has no weight, so pure tanh or pure atan costs one transcendental
+    if (typeMix <= 0.0)
+        return std::tanh(driven) * tanhScale;
+    if (typeMix >= 1.0)
+        return std::atan(driven) * atanScale;
+
+    return (1.0 - typeMix) * std::tanh(driven) * tanhScale
+           + typeMix * std::atan(driven) * atanScale;
+}
+
+WaveshaperTable::WaveshaperTable()
+    : values(static_cast<std::size_t>(numIntervals) + 1, 0.0),
+      floatValues(static_cast<std::size_t>(numIntervals) + 1, 0.0f)
+{
+}
+
+void WaveshaperTable::build(const WaveshaperCurve& newCurve)
+{
+    curve = newCurve;
+
+    for (int i = 0; i <= numIntervals; ++i)
+    {
+        const auto x = -1.0 + 2.0 * static_cast<double>(i) / static_cast<double>(numIntervals);
+        values[static_cast<std::size_t>(i)] = curve.evaluate(x);
+        floatValues[static_cast<std::size_t>(i)] = static_cast<float>(values[static_cast<std::size_t>(i)]);
+    }
+
+    harmonics.build(curve);
+    built = true;
+}
@@ -0,0 +1,60 @@
+#include "WaveshaperTableCache.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr int idlePollIntervalMs = 20;
+} // namespace
+
+std::uint64_t WaveshaperTableCache::packKey(float driveDb, float shapeType) noexcept
+{
+    std::uint32_t driveBits = 0;
+    std::uint32_t typeBits = 0;
+    std::memcpy(&driveBits, &driveDb, sizeof(driveBits));
+    std::memcpy(&typeBits, &shapeType, sizeof(typeBits));
+    return (static_cast<std::uint64_t>(driveBits) << 32) | typeBits;
+}
+
+const WaveshaperTable* WaveshaperTableCache::acquire(float driveDb, float shapeType) noexcept
+{
+    requestedKey.store(packKey(driveDb, shapeType), std::memory_order_relaxed);
+
+    if (auto* table = tables.pin())
+    {
+        if (table->matches(driveDb, shapeType))
+            return table;
+
+        tables.unpin();
+    }
+
+    return nullptr;
+}
+
+void WaveshaperTableCache::release() noexcept
+{
+    tables.unpin();
+}
+
+int WaveshaperTableCache::useTimeSlice()
+{
+    const auto key = requestedKey.load(std::memory_order_relaxed);
+    const auto driveBits = static_cast<std::uint32_t>(key >> 32);
+    const auto typeBits = static_cast<std::uint32_t>(key & 0xffffffffu);
+
+    float driveDb = 0.0f;
+    float shapeType = 0.0f;
+    std::memcpy(&driveDb, &driveBits, sizeof(driveDb));
+    std::memcpy(&shapeType, &typeBits, sizeof(shapeType));
+
+    if (auto* published = tables.getPublished())
+        if (published->matches(driveDb, shapeType))
+            return idlePollIntervalMs;
+
+    auto& table = tables.beginUpdate();
+    table.build(WaveshaperCurve::fromParameters(driveDb, shapeType));
+    tables.publish();
+
+    // Check again straight away in case the settings moved while this table was being built
+    return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "RealtimeResourceSlots.h"
+#include "WaveshaperTable.h"
+
+// Keeps a WaveshaperTable in step with the drive and shape type parameters.
+//
+// The audio thread records the settings it needs on every block and uses the table
+// only if the published one matches them exactly; otherwise it falls back to the
+// exact curve for that block. Tables are rebuilt on the BackgroundWorker when the
+// requested settings change, never on the audio thread.
+class WaveshaperTableCache : public juce::TimeSliceClient
+{
+public:
+    WaveshaperTableCache() = default;
+
+    // Audio thread: returns a table for these settings or nullptr. Call release() once the block is done.
+    const WaveshaperTable* acquire(float driveDb, float shapeType) noexcept;
+    void release() noexcept;
+
+    int useTimeSlice() override;
+
+private:
+    static std::uint64_t packKey(float driveDb, float shapeType) noexcept;
+
+    RealtimeResourceSlots<WaveshaperTable> tables;
+    std::atomic<std::uint64_t> requestedKey { packKey(-24.0f, 0.0f) };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveshaperTableCache)
+};
@@ -0,0 +1,427 @@
+#include "RealtimeSafety.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined(__APPLE__) || defined(__GLIBC__)
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+#if defined(__GLIBC__)
+ #include <dlfcn.h>
+#endif
+
+namespace
+{
+// Plain thread-locals with constant initialisers, so touching them never allocates.
+thread_local bool insideAudioCallback = false;
+thread_local int numViolations = 0;
+thread_local const char* firstViolation = "";
+
+// Hooks that call other hooked functions must report only the outermost call.
+thread_local int hookDepth = 0;
+
+void recordIfAudioThread(const char* call) noexcept
+{
+    if (! insideAudioCallback || hookDepth > 0)
+        return;
+
+    if (numViolations++ == 0)
+        firstViolation = call;
+}
+
+struct HookScope
+{
+    explicit HookScope(const char* call) noexcept
+    {
+        recordIfAudioThread(call);
+        ++hookDepth;
+    }
+
+    ~HookScope() { --hookDepth; }
+};
+} // namespace
+
+namespace RealtimeSafety
+{
+ScopedAudioCallback::ScopedAudioCallback() noexcept
+{
+    insideAudioCallback = true;
+}
+
+ScopedAudioCallback::~ScopedAudioCallback()
+{
+    insideAudioCallback = false;
+}
+
+Report takeReport() noexcept
+{
+    Report report { numViolations, firstViolation };
+    numViolations = 0;
+    firstViolation = "";
+    return report;
+}
+
+bool canCheckSystemCalls() noexcept
+{
+#if defined(__APPLE__) || defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+} // namespace RealtimeSafety
+
+//==============================================================================
+// operator new/delete, on every platform
+
+namespace
+{
+void* allocate(std::size_t size, const char* call)
+{
+    HookScope scope(call);
+
+    if (auto* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment, const char* call)
+{
+    HookScope scope(call);
+    const auto align = static_cast<std::size_t>(alignment);
+    void* memory = nullptr;
+
+#if defined(_WIN32)
+    memory = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    if (posix_memalign(&memory, align < sizeof(void*) ? sizeof(void*) : align, size == 0 ? 1 : size) != 0)
+        memory = nullptr;
+#endif
+
+    if (memory == nullptr)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void release(void* memory, const char* call) noexcept
+{
+    if (memory == nullptr)
+        return;
+
+    HookScope scope(call);
+    std::free(memory);
+}
+
+void releaseAligned(void* memory, const char* call) noexcept
+{
+    if (memory == nullptr)
+        return;
+
+    HookScope scope(call);
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size, "operator new"); }
+void* operator new[](std::size_t size) { return allocate(size, "operator new[]"); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment, "operator new"); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment, "operator new[]"); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size, "operator new"); } catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size, "operator new[]"); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* memory) noexcept { release(memory, "operator delete"); }
+void operator delete[](void* memory) noexcept { release(memory, "operator delete[]"); }
+void operator delete(void* memory, std::size_t) noexcept { release(memory, "operator delete"); }
+void operator delete[](void* memory, std::size_t) noexcept { release(memory, "operator delete[]"); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { release(memory, "operator delete"); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { release(memory, "operator delete[]"); }
+void operator delete(void* memory, std::align_val_t) noexcept { releaseAligned(memory, "operator delete"); }
+void operator delete[](void* memory, std::align_val_t) noexcept { releaseAligned(memory, "operator delete[]"); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { releaseAligned(memory, "operator delete"); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { releaseAligned(memory, "operator delete[]"); }
+
+//==============================================================================
+// C allocator, locks, waits, sleeps and file I/O
+
+#if defined(__GLIBC__)
+
+// The test executable links JUCE statically, so defining these symbols here takes every call in
+// the process. The allocator forwards to glibc's internal entry points, which never recurse back
+// into these hooks; everything else forwards to the next definition, resolved before main().
+extern "C"
+{
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void* __libc_memalign(std::size_t, std::size_t);
+void __libc_free(void*);
+
+void* malloc(std::size_t size)
+{
+    recordIfAudioThread("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+    recordIfAudioThread("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* memory, std::size_t size)
+{
+    recordIfAudioThread("realloc");
+    return __libc_realloc(memory, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size)
+{
+    recordIfAudioThread("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size)
+{
+    recordIfAudioThread("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, std::size_t alignment, std::size_t size)
+{
+    recordIfAudioThread("posix_memalign");
+    *result = __libc_memalign(alignment, size);
+    return *result != nullptr ? 0 : ENOMEM;
+}
+
+void free(void* memory)
+{
+    if (memory != nullptr)
+        recordIfAudioThread("free");
+
+    __libc_free(memory);
+}
+}
+
+namespace
+{
+template <typename Function>
+Function findNext(const char* name) noexcept
+{
+    return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+
+struct NextFunctions
+{
+    decltype(&pthread_mutex_lock) mutexLock = findNext<decltype(&pthread_mutex_lock)>("pthread_mutex_lock");
+    decltype(&pthread_cond_wait) condWait = findNext<decltype(&pthread_cond_wait)>("pthread_cond_wait");
+    decltype(&pthread_cond_timedwait) condTimedWait = findNext<decltype(&pthread_cond_timedwait)>("pthread_cond_timedwait");
+    decltype(&pthread_rwlock_rdlock) readLock = findNext<decltype(&pthread_rwlock_rdlock)>("pthread_rwlock_rdlock");
+    decltype(&pthread_rwlock_wrlock) writeLock = findNext<decltype(&pthread_rwlock_wrlock)>("pthread_rwlock_wrlock");
+    decltype(&sem_wait) semaphoreWait = findNext<decltype(&sem_wait)>("sem_wait");
+    decltype(&nanosleep) sleepNanoseconds = findNext<decltype(&nanosleep)>("nanosleep");
+    decltype(&usleep) sleepMicroseconds = findNext<decltype(&usleep)>("usleep");
+    decltype(&read) readFile = findNext<decltype(&read)>("read");
+    decltype(&write) writeFile = findNext<decltype(&write)>("write");
+};
+
+// Constructed on first use, which is always before any ScopedAudioCallback exists.
+const NextFunctions& next() noexcept
+{
+    static const NextFunctions functions;
+    return functions;
+}
+
+// Resolve everything during static initialisation, so no hook runs dlsym on the audio path
+const auto& resolvedBeforeMain = next();
+} // namespace
+
+extern "C"
+{
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    recordIfAudioThread("pthread_mutex_lock");
+    return next().mutexLock(mutex);
+}
+
+int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+{
+    recordIfAudioThread("pthread_cond_wait");
+    return next().condWait(condition, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time)
+{
+    recordIfAudioThread("pthread_cond_timedwait");
+    return next().condTimedWait(condition, mutex, time);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* lock)
+{
+    recordIfAudioThread("pthread_rwlock_rdlock");
+    return next().readLock(lock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* lock)
+{
+    recordIfAudioThread("pthread_rwlock_wrlock");
+    return next().writeLock(lock);
+}
+
+int sem_wait(sem_t* semaphore)
+{
+    recordIfAudioThread("sem_wait");
+    return next().semaphoreWait(semaphore);
+}
+
+int nanosleep(const struct timespec* duration, struct timespec* remaining)
+{
+    recordIfAudioThread("nanosleep");
+    return next().sleepNanoseconds(duration, remaining);
+}
+
+int usleep(useconds_t microseconds)
+{
+    recordIfAudioThread("usleep");
+    return next().sleepMicroseconds(microseconds);
+}
+
+ssize_t read(int file, void* data, std::size_t size)
+{
+    recordIfAudioThread("read");
+    return next().readFile(file, data, size);
+}
+
+ssize_t write(int file, const void* data, std::size_t size)
+{
+    recordIfAudioThread("write");
+    return next().writeFile(file, data, size);
+}
+}
+
+#elif defined(__APPLE__)
+
+ #include <malloc/malloc.h>
+
+// dyld applies __interpose tuples to every image but the one that defines them, so the
+// replacements below call the real functions directly.
+ #define REALTIME_SAFETY_INTERPOSE(replacement, original)                                           \
+     __attribute__((used)) static const struct                                                       \
+     {                                                                                               \
+         const void* replacementFunction;                                                            \
+         const void* originalFunction;                                                               \
+     } interpose_##original __attribute__((section("__DATA,__interpose"))) = {                       \
+         reinterpret_cast<const void*>(&replacement), reinterpret_cast<const void*>(&original)       \
+     };
+
+// libmalloc reports every allocation and free to this logger, the same hook the
+// MallocStackLogging tools use, which also covers allocations made inside system libraries.
+typedef void(MallocLogger)(std::uint32_t, std::uintptr_t, std::uintptr_t, std::uintptr_t, std::uintptr_t, std::uint32_t);
+extern "C" MallocLogger* malloc_logger;
+
+namespace
+{
+void logAllocation(std::uint32_t, std::uintptr_t, std::uintptr_t, std::uintptr_t, std::uintptr_t, std::uint32_t)
+{
+    recordIfAudioThread("malloc");
+}
+
+const bool allocationLoggerInstalled = []
+{
+    malloc_logger = logAllocation;
+    return true;
+}();
+
+int checkedMutexLock(pthread_mutex_t* mutex)
+{
+    recordIfAudioThread("pthread_mutex_lock");
+    return pthread_mutex_lock(mutex);
+}
+
+int checkedCondWait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+{
+    recordIfAudioThread("pthread_cond_wait");
+    return pthread_cond_wait(condition, mutex);
+}
+
+int checkedCondTimedWait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time)
+{
+    recordIfAudioThread("pthread_cond_timedwait");
+    return pthread_cond_timedwait(condition, mutex, time);
+}
+
+int checkedReadLock(pthread_rwlock_t* lock)
+{
+    recordIfAudioThread("pthread_rwlock_rdlock");
+    return pthread_rwlock_rdlock(lock);
+}
+
+int checkedWriteLock(pthread_rwlock_t* lock)
+{
+    recordIfAudioThread("pthread_rwlock_wrlock");
+    return pthread_rwlock_wrlock(lock);
+}
+
+int checkedSemaphoreWait(sem_t* semaphore)
+{
+    recordIfAudioThread("sem_wait");
+    return sem_wait(semaphore);
+}
+
+int checkedNanosleep(const struct timespec* duration, struct timespec* remaining)
+{
+    recordIfAudioThread("nanosleep");
+    return nanosleep(duration, remaining);
+}
+
+int checkedUsleep(useconds_t microseconds)
+{
+    recordIfAudioThread("usleep");
+    return usleep(microseconds);
+}
+
+ssize_t checkedRead(int file, void* data, std::size_t size)
+{
+    recordIfAudioThread("read");
+    return read(file, data, size);
+}
+
+ssize_t checkedWrite(int file, const void* data, std::size_t size)
+{
+    recordIfAudioThread("write");
+    return write(file, data, size);
+}
+} // namespace
+
+REALTIME_SAFETY_INTERPOSE(checkedMutexLock, pthread_mutex_lock)
+REALTIME_SAFETY_INTERPOSE(checkedCondWait, pthread_cond_wait)
+REALTIME_SAFETY_INTERPOSE(checkedCondTimedWait, pthread_cond_timedwait)
+REALTIME_SAFETY_INTERPOSE(checkedReadLock, pthread_rwlock_rdlock)
+REALTIME_SAFETY_INTERPOSE(checkedWriteLock, pthread_rwlock_wrlock)
+REALTIME_SAFETY_INTERPOSE(checkedSemaphoreWait, sem_wait)
+REALTIME_SAFETY_INTERPOSE(checkedNanosleep, nanosleep)
+REALTIME_SAFETY_INTERPOSE(checkedUsleep, usleep)
+REALTIME_SAFETY_INTERPOSE(checkedRead, read)
+REALTIME_SAFETY_INTERPOSE(checkedWrite, write)
+
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+// Test-only instrumentation that flags allocations, locks and blocking calls on the audio path.
+//
+// RealtimeSafety.cpp replaces operator new/delete and, where the platform allows, interposes
+// malloc and friends, mutex and condition-variable waits, sleeps and file I/O. The hooks are
+// always installed but only report while a ScopedAudioCallback is alive on the calling thread,
+// so the harness can wrap exactly the processBlock call and let the rest of the test, the
+// message thread and the background worker allocate and lock freely.
+namespace RealtimeSafety
+{
+// Marks the current thread as running the audio callback for the lifetime of the object.
+class ScopedAudioCallback
+{
+public:
+    ScopedAudioCallback() noexcept;
+    ~ScopedAudioCallback();
+
+    ScopedAudioCallback(const ScopedAudioCallback&) = delete;
+    ScopedAudioCallback& operator=(const ScopedAudioCallback&) = delete;
+};
+
+struct Report
+{
+    int numViolations = 0;
+
+    // Name of the first offending call, e.g. "malloc" or "pthread_mutex_lock"; never allocated.
+    const char* firstViolation = "";
+};
+
+// Returns what the hooks saw on this thread since the last call, and clears it.
+Report takeReport() noexcept;
+
+// False on platforms where only operator new/delete can be checked.
+bool canCheckSystemCalls() noexcept;
+} // namespace RealtimeSafety
@@ -0,0 +1,77 @@
+/* Builds as C and links only the DualToneC shared library, so it checks that the header is valid
+ * C and that the library exports everything it declares. Exits non-zero on the first failure. */
+
+#include "DualToneC.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define CHECK(condition)                                                              \
+    do                                                                                \
+    {                                                                                 \
+        if (! (condition))                                                            \
+        {                                                                             \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            return 1;                                                                 \
+        }                                                                             \
+    } while (0)
+
+enum { numFrames = 1024 };
+
+static float peak(const float* samples, int count)
+{
+    float level = 0.0f;
+
+    for (int i = 0; i < count; ++i)
+        level = fabsf(samples[i]) > level ? fabsf(samples[i]) : level;
+
+    return level;
+}
+
+int main(void)
+{
+    static float left[numFrames];
+    static float right[numFrames];
+    static float seekLeft[numFrames];
+    static float seekRight[numFrames];
+    void* channels[] = { left, right };
+    void* seekChannels[] = { seekLeft, seekRight };
+
+    CHECK(dualtone_create(48000.0, 0) == NULL);
+
+    DualToneGenerator* generator = dualtone_create(48000.0, 2);
+    DualToneGenerator* seeking = dualtone_create(48000.0, 2);
+    CHECK(generator != NULL);
+    CHECK(seeking != NULL);
+
+    CHECK(dualtone_set_parameter(generator, DUALTONE_CENTER_FREQ, 330.0f) == DUALTONE_OK);
+    CHECK(dualtone_set_parameter(seeking, DUALTONE_CENTER_FREQ, 330.0f) == DUALTONE_OK);
+    CHECK(dualtone_get_parameter(generator, DUALTONE_CENTER_FREQ) == 330.0f);
+
+    /* The first render settles the ramps from the defaults; the second carries on from it */
+    CHECK(dualtone_render_planar(generator, channels, numFrames, DUALTONE_FLOAT32) == DUALTONE_OK);
+    CHECK(dualtone_render_planar(generator, channels, numFrames, DUALTONE_FLOAT32) == DUALTONE_OK);
+    CHECK(peak(left, numFrames) > 0.01f);
+    CHECK(peak(right, numFrames) > 0.01f);
+
+    /* Seeking a fresh generator to where the second render started gives the same samples */
+    CHECK(dualtone_render_planar(seeking, seekChannels, numFrames, DUALTONE_FLOAT32) == DUALTONE_OK);
+    CHECK(dualtone_seek(seeking, numFrames) == DUALTONE_OK);
+    CHECK(dualtone_render_planar(seeking, seekChannels, numFrames, DUALTONE_FLOAT32) == DUALTONE_OK);
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        CHECK(fabsf(seekLeft[i] - left[i]) < 1.0e-4f);
+        CHECK(fabsf(seekRight[i] - right[i]) < 1.0e-4f);
+    }
+
+    CHECK(dualtone_seek(seeking, -1) == DUALTONE_INVALID_ARGUMENT);
+    CHECK(dualtone_render_planar(NULL, channels, numFrames, DUALTONE_FLOAT32) == DUALTONE_INVALID_ARGUMENT);
+
+    dualtone_destroy(seeking);
+    dualtone_destroy(generator);
+    dualtone_destroy(NULL);
+
+    printf("DualTone C API: all checks passed\n");
+    return 0;
+}
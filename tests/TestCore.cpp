@@ -0,0 +1,570 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <juce_core/juce_core.h>
+#include "DualToneC.h"
+#include "DualToneEngine.h"
+#include "OfflineRenderer.h"
+#include "PeriodicRenderCache.h"
+#include "ParameterSnapshot.h"
+#include "PluginState.h"
+#include "ProcessLoadMeter.h"
+#include "SineOscillator.h"
+#include "WaveshaperTable.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Tests of the DSP building blocks in DualToneCore. They need no message manager, so unlike the
+// processor tests none of them starts one.
+
+namespace
+{
+// Parameter values for an engine, starting from every parameter's default.
+struct EngineParameters
+{
+    EngineParameters()
+    {
+        for (size_t index = 0; index < values.size(); ++index)
+        {
+            values[index] = PluginState::parameterRanges[index].defaultValue;
+            pointers[index] = &values[index];
+        }
+    }
+
+    std::array<std::atomic<float>, PluginState::numParameters> values;
+    DualToneEngine::ParameterValues pointers;
+};
+} // namespace
+
+TEST_CASE("WaveshaperTable Error Bound Test", "[shaper]")
+{
+    for (const auto driveDb : { -24.0f, 0.0f, 6.0f, 12.0f })
+    {
+        for (const auto shapeType : { 0.0f, 0.5f, 1.0f })
+        {
+            const auto curve = WaveshaperCurve::fromParameters(driveDb, shapeType);
+            WaveshaperTable table;
+            table.build(curve);
+
+            double maxError = 0.0;
+            for (int i = 0; i <= 100000; ++i)
+            {
+                const auto x = -1.0 + 2.0 * static_cast<double>(i) / 100000.0;
+                maxError = std::max(maxError, std::abs(table.lookup(x) - curve.evaluate(x)));
+            }
+
+            REQUIRE(maxError < 4.0e-7);
+        }
+    }
+}
+
+TEST_CASE("HarmonicSeries Resynthesis Test", "[shaper]")
+{
+    const auto curve = WaveshaperCurve::fromParameters(12.0f, 0.5f);
+    HarmonicSeries series;
+    series.build(curve);
+
+    constexpr int numSamples = 512;
+    double sine[numSamples];
+    double shaped[numSamples];
+
+    for (int i = 0; i < numSamples; ++i)
+        sine[i] = std::sin(0.0123 * static_cast<double>(i));
+
+    // With every significant harmonic kept the series reproduces the curve itself
+    series.render(sine, shaped, numSamples, series.getNumSignificantHarmonics());
+
+    for (int i = 0; i < numSamples; ++i)
+        REQUIRE(shaped[i] == Catch::Approx(curve.evaluate(sine[i])).margin(1.0e-6));
+
+    // A tone near Nyquist keeps only its fundamental
+    REQUIRE(series.getNumHarmonicsBelow(15000.0, 44100.0) == 1);
+}
+
+TEST_CASE("SineOscillator Seek Test", "[oscillator]")
+{
+    const auto increment = juce::MathConstants<double>::twoPi * 517.3 / 48000.0;
+
+    SineOscillator running;
+    SineOscillator seeked;
+    running.setPhaseIncrement(increment);
+    seeked.setPhaseIncrement(increment);
+
+    // Render a little over an hour in uneven blocks, then jump a second oscillator straight there
+    std::vector<float> block(4099);
+    std::uint64_t position = 0;
+
+    for (int i = 0; i < 42200; ++i)
+    {
+        running.render(block.data(), static_cast<int>(block.size()));
+        position += block.size();
+    }
+
+    seeked.seek(0, position);
+    REQUIRE(seeked.getFixedPhase() == running.getFixedPhase());
+
+    std::vector<double> fromRunning(1024);
+    std::vector<double> fromSeeked(1024);
+    running.render(fromRunning.data(), 1024);
+    seeked.render(fromSeeked.data(), 1024);
+    REQUIRE(fromRunning == fromSeeked);
+
+    // The fixed-point accumulator does not drift from the analytic phase
+    const auto expectedPhase = std::fmod(running.getPhaseIncrement() * static_cast<double>(position + 1024),
+                                         juce::MathConstants<double>::twoPi);
+    REQUIRE(std::remainder(running.getPhase() - expectedPhase, juce::MathConstants<double>::twoPi) == Catch::Approx(0.0).margin(1.0e-6));
+}
+
+TEST_CASE("ProcessLoadMeter Statistics Test", "[load]")
+{
+    ProcessLoadMeter meter;
+    meter.prepare(48000.0);
+    REQUIRE(meter.getStats().numBlocks == 0);
+
+    // 480 samples at 48 kHz leave 10 ms; block n takes n% of that
+    const auto ticksPerPercent = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) * 0.01 / 100.0;
+    for (int percent = 1; percent <= 100; ++percent)
+        meter.addBlock(juce::roundToInt(ticksPerPercent * percent), 480);
+
+    auto stats = meter.getStats();
+    REQUIRE(stats.numBlocks == 100);
+    REQUIRE(stats.meanPercent == Catch::Approx(50.5).margin(0.05));
+    REQUIRE(stats.p99Percent == Catch::Approx(99.0).margin(0.05));
+    REQUIRE(stats.peakPercent == Catch::Approx(100.0).margin(0.05));
+
+    // Only the most recent window counts
+    for (int block = 0; block < ProcessLoadMeter::windowSize; ++block)
+        meter.addBlock(juce::roundToInt(ticksPerPercent * 5.0), 480);
+
+    stats = meter.getStats();
+    REQUIRE(stats.numBlocks == ProcessLoadMeter::windowSize);
+    REQUIRE(stats.peakPercent == Catch::Approx(5.0).margin(0.05));
+}
+
+TEST_CASE("ParameterSnapshot Batch Test", "[parameters]")
+{
+    std::array<std::atomic<float>, PluginState::numParameters> values {};
+    ParameterSnapshot::Sources sources;
+
+    for (size_t index = 0; index < values.size(); ++index)
+        sources[index] = &values[index];
+
+    ParameterSnapshot snapshot;
+    snapshot.setSources(sources);
+    const auto firstVersion = snapshot.getVersion();
+
+    // Nothing changed, so the version stays and derived values can be kept
+    REQUIRE_FALSE(snapshot.update());
+    REQUIRE(snapshot.getVersion() == firstVersion);
+
+    // A single value written outside any batch is picked up by the next update
+    values[PluginState::gain] = 6.0f;
+    REQUIRE(snapshot.update());
+    REQUIRE(snapshot[PluginState::gain] == 6.0f);
+    REQUIRE(snapshot.getVersion() != firstVersion);
+
+    {
+        ParameterSnapshot::ScopedBatch batch(snapshot);
+        values[PluginState::centerFreq] = 440.0f;
+        REQUIRE_FALSE(snapshot.update());
+
+        {
+            // Nested batches hold the snapshot until the outermost one ends
+            ParameterSnapshot::ScopedBatch inner(snapshot);
+            values[PluginState::spread] = 5.0f;
+        }
+
+        REQUIRE_FALSE(snapshot.update());
+        REQUIRE(snapshot[PluginState::centerFreq] == 0.0f);
+        REQUIRE(snapshot[PluginState::spread] == 0.0f);
+    }
+
+    REQUIRE(snapshot.update());
+    REQUIRE(snapshot[PluginState::centerFreq] == 440.0f);
+    REQUIRE(snapshot[PluginState::spread] == 5.0f);
+}
+
+TEST_CASE("ParameterSnapshot Override Test", "[parameters]")
+{
+    std::array<std::atomic<float>, PluginState::numParameters> values {};
+    ParameterSnapshot::Sources sources;
+
+    for (size_t index = 0; index < values.size(); ++index)
+        sources[index] = &values[index];
+
+    ParameterSnapshot snapshot;
+    snapshot.setSources(sources);
+
+    ParameterSnapshot::Values preset {};
+    preset[PluginState::centerFreq] = 400.0f;
+    preset[PluginState::gain] = 3.0f;
+
+    // An override takes effect at once and survives updates while the sources stay where they were
+    const auto generationBefore = snapshot.getOverrideGeneration();
+    snapshot.overrideValues(preset);
+    REQUIRE(snapshot[PluginState::centerFreq] == 400.0f);
+    REQUIRE_FALSE(snapshot.update());
+    REQUIRE(snapshot[PluginState::centerFreq] == 400.0f);
+    REQUIRE(values[PluginState::centerFreq].load() == 0.0f);
+
+    // A source written since, e.g. by the host, takes over from its overridden value
+    values[PluginState::gain] = 5.0f;
+    REQUIRE(snapshot.update());
+    REQUIRE(snapshot[PluginState::gain] == 5.0f);
+    REQUIRE(snapshot[PluginState::centerFreq] == 400.0f);
+
+    // Releasing the generation hands every value back to the sources, even one written back unchanged
+    const auto generation = snapshot.getOverrideGeneration();
+    REQUIRE(generation != generationBefore);
+    values[PluginState::centerFreq] = 0.0f;
+    snapshot.releaseOverride(generation);
+    REQUIRE(snapshot.update());
+    REQUIRE(snapshot[PluginState::centerFreq] == 0.0f);
+
+    // An override made after the generation that was read stands
+    const auto staleGeneration = snapshot.getOverrideGeneration();
+    snapshot.overrideValues(preset);
+    snapshot.releaseOverride(staleGeneration);
+    snapshot.update();
+    REQUIRE(snapshot[PluginState::centerFreq] == 400.0f);
+}
+
+TEST_CASE("PluginState Binary Validation Test", "[state]")
+{
+    PluginState source;
+
+    for (size_t index = 0; index < source.values.size(); ++index)
+        source.values[index] = PluginState::parameterRanges[index].defaultValue;
+
+    source.values[PluginState::centerFreq] = 5000.0f;
+    source.values[PluginState::oversampling] = 2.4f;
+    source.toneBank.numPartials = 2;
+    source.toneBank.levels[0] = 0.5;
+    source.toneBank.pans[1] = 3.0;
+
+    // Out of range values are clamped to their parameter's range, and choices are rounded
+    juce::MemoryBlock data;
+    source.writeBinary(data);
+
+    PluginState decoded;
+    REQUIRE(decoded.readBinary(data.getData(), data.getSize()));
+    REQUIRE(decoded.values[PluginState::centerFreq] == 600.0f);
+    REQUIRE(decoded.values[PluginState::oversampling] == 2.0f);
+    REQUIRE(decoded.values[PluginState::drive] == -24.0f);
+    REQUIRE(decoded.toneBank.pans[1] == 1.0);
+
+    // A value that is not finite rejects the whole state
+    for (const auto corrupt : { std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity() })
+    {
+        source.values[PluginState::spread] = corrupt;
+        source.writeBinary(data);
+
+        PluginState untouched = decoded;
+        REQUIRE_FALSE(untouched.readBinary(data.getData(), data.getSize()));
+        REQUIRE(untouched.values == decoded.values);
+    }
+
+    source.values[PluginState::spread] = 2.0f;
+    source.toneBank.offsetsHz[1] = std::numeric_limits<double>::quiet_NaN();
+    source.writeBinary(data);
+    REQUIRE_FALSE(decoded.readBinary(data.getData(), data.getSize()));
+}
+
+TEST_CASE("OfflineRenderer Thread Count Test", "[render]")
+{
+    OfflineRenderer::Options options;
+    options.sampleRate = 48000.0;
+    options.lengthInSamples = 150000;
+    options.chunkLength = 16384;
+    options.blockSize = 1000;
+
+    auto state = OfflineRenderer::getDefaultState();
+    state.values[PluginState::centerFreq] = 517.3f;
+    state.values[PluginState::spread] = 7.3f;
+    state.values[PluginState::drive] = 3.0f;
+
+    auto renderWith = [&](int numThreads, int chunkLength, int blockSize)
+    {
+        juce::AudioBuffer<float> output(2, static_cast<int>(options.lengthInSamples));
+        auto written = 0;
+        auto chunkOptions = options;
+        chunkOptions.numThreads = numThreads;
+        chunkOptions.chunkLength = chunkLength;
+        chunkOptions.blockSize = blockSize;
+
+        REQUIRE(OfflineRenderer::render(chunkOptions, state, [&](const juce::AudioBuffer<float>& chunk, int numSamples)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                output.copyFrom(ch, written, chunk, ch, 0, numSamples);
+
+            written += numSamples;
+            return true;
+        }));
+
+        REQUIRE(written == options.lengthInSamples);
+        return output;
+    };
+
+    const auto singleThreaded = renderWith(1, options.chunkLength, options.blockSize);
+    const auto multiThreaded = renderWith(4, options.chunkLength, options.blockSize);
+
+    // Every chunk starts from its analytic phase, so the thread count cannot change a single bit
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < singleThreaded.getNumSamples(); ++i)
+            REQUIRE(multiThreaded.getSample(ch, i) == singleThreaded.getSample(ch, i));
+
+    // and the chunks join up with one engine running straight through in a single block
+    const auto length = static_cast<int>(options.lengthInSamples);
+    const auto reference = renderWith(1, length, length);
+
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < reference.getNumSamples(); ++i)
+            REQUIRE(singleThreaded.getSample(ch, i) == Catch::Approx(reference.getSample(ch, i)).margin(1.0e-5));
+}
+
+TEST_CASE("DualToneEngine Render Cache Test", "[engine]")
+{
+    // Plays the same settings from the cache and live, and returns the largest difference seen
+    auto compareWithLive = [](float centerFrequency, float spread, int& firstCachedBlock)
+    {
+        EngineParameters cachedParameters;
+        EngineParameters liveParameters;
+        DualToneEngine cachedEngine;
+        DualToneEngine liveEngine;
+
+        for (auto* parameters : { &cachedParameters, &liveParameters })
+        {
+            parameters->values[PluginState::centerFreq] = centerFrequency;
+            parameters->values[PluginState::spread] = spread;
+            parameters->values[PluginState::drive] = 6.0f;
+        }
+
+        cachedEngine.setParameterValues(cachedParameters.pointers);
+        liveEngine.setParameterValues(liveParameters.pointers);
+
+        // Non-realtime processing never plays from the cache, so the live engine is the reference
+        liveEngine.setNonRealtime(true);
+
+        for (auto* engine : { &cachedEngine, &liveEngine })
+        {
+            engine->prepare(48000.0);
+            engine->setChannelLayout(juce::AudioChannelSet::stereo());
+        }
+
+        const int blockSize = 512;
+        const int numBlocks = 60;
+        const int totalSamples = blockSize * numBlocks;
+        juce::AudioBuffer<double> cachedOutput(2, totalSamples);
+        const juce::MidiBuffer midiBuffer;
+        firstCachedBlock = -1;
+
+        // One slice of background work between blocks, standing in for the worker
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            juce::AudioBuffer<double> buffer(cachedOutput.getArrayOfWritePointers(), 2, block * blockSize, blockSize);
+            cachedEngine.process(buffer, midiBuffer);
+            cachedEngine.runBackgroundWork();
+
+            if (firstCachedBlock < 0 && cachedEngine.isPlayingFromCache())
+                firstCachedBlock = block;
+        }
+
+        // The settings were still throughout, so playback stayed on the cache once it got there
+        REQUIRE(cachedEngine.isPlayingFromCache());
+
+        juce::AudioBuffer<double> liveOutput(2, totalSamples);
+        liveEngine.process(liveOutput, midiBuffer);
+        REQUIRE_FALSE(liveEngine.isPlayingFromCache());
+
+        auto maxDifference = 0.0;
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < totalSamples; ++i)
+                maxDifference = std::max(maxDifference, std::abs(cachedOutput.getSample(ch, i) - liveOutput.getSample(ch, i)));
+
+        // A parameter change hands back to live synthesis, which continues from the phases the cache ended on
+        for (auto* parameters : { &cachedParameters, &liveParameters })
+            parameters->values[PluginState::spread] = spread + 2.0f;
+
+        juce::AudioBuffer<double> cachedTail(2, blockSize);
+        juce::AudioBuffer<double> liveTail(2, blockSize);
+        cachedEngine.process(cachedTail, midiBuffer);
+        liveEngine.process(liveTail, midiBuffer);
+        REQUIRE_FALSE(cachedEngine.isPlayingFromCache());
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                maxDifference = std::max(maxDifference, std::abs(cachedTail.getSample(ch, i) - liveTail.getSample(ch, i)));
+
+        return maxDifference;
+    };
+
+    auto firstCachedBlock = -1;
+
+    // 430 Hz and 450 Hz at 48 kHz complete whole cycles every 4800 and 320 samples, so the loops are exact
+    REQUIRE(compareWithLive(440.0f, 10.0f, firstCachedBlock) < 1.0e-6);
+    REQUIRE(firstCachedBlock > 0);
+
+    // Neither tone of this pair has a short exact period. The loops come back within maxPhaseError,
+    // so the cache drifts from live synthesis by a few millionths of a cycle per pass at most
+    REQUIRE(compareWithLive(441.37f, 7.31f, firstCachedBlock) < 1.0e-3);
+    REQUIRE(firstCachedBlock > 0);
+
+    // Every step finds a period inside the stored length
+    for (auto frequency : { 20.01, 437.715, 445.025, 1000.123, 15678.9 })
+    {
+        const auto step = FixedPhase::fromRadians(FixedPhase::twoPi * frequency / 48000.0);
+        REQUIRE(PeriodicRenderCache::findPeriod(step, PeriodicRenderCache::maxPeriodLength) > 0);
+    }
+}
+
+TEST_CASE("DualToneEngine Tone Bank Glide Test", "[engine]")
+{
+    EngineParameters parameters;
+    DualToneEngine engine;
+    engine.setParameterValues(parameters.pointers);
+    engine.setNonRealtime(true);
+    engine.prepare(48000.0);
+    engine.setChannelLayout(juce::AudioChannelSet::stereo());
+
+    ToneBankLayout chord;
+    chord.numPartials = 8;
+    for (int partial = 0; partial < chord.numPartials; ++partial)
+    {
+        chord.offsetsHz[partial] = 10.0 * partial;
+        chord.levels[partial] = 0.2;
+        chord.pans[partial] = -1.0 + 2.0 * partial / (chord.numPartials - 1);
+    }
+
+    const int blockSize = 500;
+    juce::AudioBuffer<double> block(2, blockSize);
+    const juce::MidiBuffer midiBuffer;
+    std::vector<double> left;
+
+    auto run = [&](int numBlocks)
+    {
+        for (int index = 0; index < numBlocks; ++index)
+        {
+            engine.process(block, midiBuffer);
+            left.insert(left.end(), block.getReadPointer(0), block.getReadPointer(0) + blockSize);
+        }
+    };
+
+    // A step in level or phase shows up as a spike in the second difference
+    auto maxCurvature = [&left](size_t first, size_t last)
+    {
+        auto curvature = 0.0;
+
+        for (auto i = first + 1; i + 1 < last; ++i)
+            curvature = std::max(curvature, std::abs(left[i + 1] - 2.0 * left[i] + left[i - 1]));
+
+        return curvature;
+    };
+
+    run(10);
+    REQUIRE_FALSE(engine.isToneBankActive());
+
+    // From the pair into the bank and back, each switch gliding over the 50 ms ramp
+    engine.setToneBank(chord);
+    REQUIRE(engine.isToneBankActive());
+    run(20);
+
+    engine.setToneBank({});
+    REQUIRE_FALSE(engine.isToneBankActive());
+    run(20);
+
+    const auto steadyPair = maxCurvature(0, 5000);
+    const auto steadyBank = maxCurvature(10000, 15000);
+    const auto bound = 2.0 * std::max(steadyPair, steadyBank);
+
+    REQUIRE(steadyPair > 0.0);
+    REQUIRE(steadyBank > 0.0);
+    REQUIRE(maxCurvature(4000, 10000) < bound);
+    REQUIRE(maxCurvature(14000, 25000) < bound);
+}
+
+TEST_CASE("DualTone C API Render Test", "[capi]")
+{
+    REQUIRE(dualtone_create(48000.0, 0) == nullptr);
+    REQUIRE(dualtone_create(48000.0, 9) == nullptr);
+    REQUIRE(dualtone_create(0.0, 2) == nullptr);
+
+    auto* planar = dualtone_create(48000.0, 2);
+    auto* interleaved = dualtone_create(48000.0, 2);
+    REQUIRE(planar != nullptr);
+    REQUIRE(interleaved != nullptr);
+
+    // Parameters are clamped to their ranges and choices are rounded
+    const auto& centerRange = PluginState::parameterRanges[PluginState::centerFreq];
+    REQUIRE(dualtone_get_parameter(planar, DUALTONE_CENTER_FREQ) == centerRange.defaultValue);
+    REQUIRE(dualtone_set_parameter(planar, DUALTONE_CENTER_FREQ, centerRange.maximum + 400.0f) == DUALTONE_OK);
+    REQUIRE(dualtone_get_parameter(planar, DUALTONE_CENTER_FREQ) == centerRange.maximum);
+    REQUIRE(dualtone_set_parameter(planar, DUALTONE_OVERSAMPLING, 1.4f) == DUALTONE_OK);
+    REQUIRE(dualtone_get_parameter(planar, DUALTONE_OVERSAMPLING) == 1.0f);
+    REQUIRE(dualtone_set_parameter(planar, DUALTONE_NUM_PARAMETERS, 0.0f) == DUALTONE_INVALID_ARGUMENT);
+
+    // Both generators start from the same settings, so their outputs match sample for sample
+    const float settings[] = { 220.0f, 3.0f, -0.5f, 0.5f, 0.0f, -6.0f, 0.0f, 6.0f, 0.3f, 0.0f, 0.0f };
+    REQUIRE(dualtone_set_parameters(planar, settings, 11) == DUALTONE_OK);
+    REQUIRE(dualtone_set_parameters(interleaved, settings, 11) == DUALTONE_OK);
+
+    constexpr int numFrames = 1500;
+    std::vector<float> left(numFrames);
+    std::vector<float> right(numFrames);
+    void* channels[] = { left.data(), right.data() };
+    REQUIRE(dualtone_render_planar(planar, channels, numFrames, DUALTONE_FLOAT32) == DUALTONE_OK);
+
+    std::vector<std::int16_t> frames(2 * numFrames);
+    REQUIRE(dualtone_render_interleaved(interleaved, frames.data(), numFrames, DUALTONE_INT16) == DUALTONE_OK);
+
+    auto peak = 0.0f;
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        REQUIRE(std::abs(frames[2 * frame] - left[frame] * 32767.0f) <= 1.0f);
+        REQUIRE(std::abs(frames[2 * frame + 1] - right[frame] * 32767.0f) <= 1.0f);
+        peak = std::max(peak, std::abs(left[frame]));
+    }
+
+    REQUIRE(peak > 0.01f);
+
+    dualtone_destroy(planar);
+    dualtone_destroy(interleaved);
+    dualtone_destroy(nullptr);
+}
+
+TEST_CASE("DualTone C API Seek Test", "[capi]")
+{
+    // Parameters left at their defaults never ramp, so a seek lands exactly where running would
+    auto* running = dualtone_create(44100.0, 1);
+    auto* seeked = dualtone_create(44100.0, 1);
+
+    constexpr int numFrames = 2000;
+    std::vector<float> output(numFrames);
+    void* channels[] = { output.data() };
+
+    for (int block = 0; block < 7; ++block)
+        REQUIRE(dualtone_render_planar(running, channels, numFrames, DUALTONE_FLOAT32) == DUALTONE_OK);
+
+    REQUIRE(dualtone_seek(seeked, 7 * numFrames) == DUALTONE_OK);
+    REQUIRE(dualtone_seek(seeked, -1) == DUALTONE_INVALID_ARGUMENT);
+    REQUIRE(dualtone_render_planar(running, channels, numFrames, DUALTONE_FLOAT32) == DUALTONE_OK);
+
+    std::vector<std::uint8_t> packed(3 * numFrames);
+    REQUIRE(dualtone_render_interleaved(seeked, packed.data(), numFrames, DUALTONE_INT24) == DUALTONE_OK);
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        const auto* bytes = packed.data() + 3 * frame;
+        auto sample = static_cast<std::int32_t>(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16));
+        sample = sample >= 0x800000 ? sample - 0x1000000 : sample;
+        REQUIRE(std::abs(static_cast<float>(sample) - output[frame] * 8388607.0f) <= 2.0f);
+    }
+
+    dualtone_destroy(running);
+    dualtone_destroy(seeked);
+}
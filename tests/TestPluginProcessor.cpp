@@ -1,7 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <juce_gui_basics/juce_gui_basics.h>
+#include "EditorAssets.h"
+#include "KnobImageAtlas.h"
+#include "PluginEditor.h"
 #include "PluginProcessor.h"
+#include "PluginState.h"
+
+#include <thread>
 
 TEST_CASE("DualToneGeneratorAudioProcessor Frequency Test", "[processor]")
 {
@@ -36,7 +42,7 @@ TEST_CASE("DualToneGeneratorAudioProcessor Frequency Test", "[processor]")
     juce::AudioBuffer<float> buffer(2, samplesPerBlock);
     juce::MidiBuffer midiBuffer;
 
-    // Process a few blocks to let things settle (though there's no smoothing on these params currently, good practice)
+    // Process a few blocks to let the parameter ramps settle
     processor.processBlock(buffer, midiBuffer);
     processor.processBlock(buffer, midiBuffer);
 
@@ -81,3 +87,830 @@ TEST_CASE("DualToneGeneratorAudioProcessor Frequency Test", "[processor]")
     REQUIRE(measuredFreqLeft == Catch::Approx(430.0).margin(1.0));
     REQUIRE(measuredFreqRight == Catch::Approx(450.0).margin(1.0));
 }
+
+TEST_CASE("DualToneGeneratorAudioProcessor Block Continuity Test", "[processor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const double sampleRate = 48000.0;
+    const int totalSamples = 4096;
+
+    auto render = [&](int blockSize)
+    {
+        DualToneGeneratorAudioProcessor processor;
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        auto& params = processor.getValueTreeState();
+        *params.getRawParameterValue("centerFreq") = 517.3f;
+        *params.getRawParameterValue("spread") = 7.9f;
+
+        juce::AudioBuffer<float> output(2, totalSamples);
+        juce::AudioBuffer<float> block(2, blockSize);
+        juce::MidiBuffer midiBuffer;
+
+        for (int start = 0; start < totalSamples; start += blockSize)
+        {
+            processor.processBlock(block, midiBuffer);
+            for (int ch = 0; ch < 2; ++ch)
+                output.copyFrom(ch, start, block, ch, 0, blockSize);
+        }
+
+        return output;
+    };
+
+    // One long block and many small blocks must produce the same waveform
+    const auto reference = render(totalSamples);
+    const auto blocked = render(64);
+
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < totalSamples; ++i)
+            REQUIRE(blocked.getSample(ch, i) == Catch::Approx(reference.getSample(ch, i)).margin(1.0e-5));
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Oversampling Latency Test", "[processor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    auto& params = processor.getValueTreeState();
+    *params.getRawParameterValue("drive") = 12.0f;
+    *params.getRawParameterValue("oversampling") = 2.0f; // 4x
+
+    const double sampleRate = 44100.0;
+    processor.prepareToPlay(sampleRate, 512);
+
+    // The selected stage's latency is reported to the host and doubles as the tail length
+    REQUIRE(processor.getLatencySamples() > 0);
+    REQUIRE(processor.getTailLengthSeconds() == Catch::Approx(processor.getLatencySamples() / sampleRate));
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midiBuffer;
+    processor.processBlock(buffer, midiBuffer);
+
+    // Priming fills the filters with history, so even the first block carries signal from its first samples
+    REQUIRE(buffer.getMagnitude(0, 0, 32) > 0.01f);
+
+    // A change made on the message thread reaches the host straight away
+    auto* oversampling = params.getParameter("oversampling");
+    oversampling->setValueNotifyingHost(oversampling->convertTo0to1(0.0f));
+    REQUIRE(processor.getLatencySamples() == 0);
+
+    oversampling->setValueNotifyingHost(oversampling->convertTo0to1(1.0f));
+    const auto latency = processor.getLatencySamples();
+    REQUIRE(latency > 0);
+
+    // Automation from any other thread leaves the host alone until the message thread catches up
+    std::thread automation([oversampling] { oversampling->setValueNotifyingHost(oversampling->convertTo0to1(0.0f)); });
+    automation.join();
+    REQUIRE(processor.getLatencySamples() == latency);
+
+    processor.prepareToPlay(sampleRate, 512);
+    REQUIRE(processor.getLatencySamples() == 0);
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Parameter Smoothing Test", "[processor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    auto& params = processor.getValueTreeState();
+    *params.getRawParameterValue("spread") = 0.0f;
+    *params.getRawParameterValue("gain") = -12.0f;
+    processor.prepareToPlay(44100.0, 512);
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midiBuffer;
+    processor.processBlock(buffer, midiBuffer);
+    const auto quietLevel = buffer.getMagnitude(0, 0, 512);
+    const auto lastQuietSample = buffer.getSample(0, 511);
+
+    // A 24 dB jump must ramp in over several blocks instead of stepping at the block boundary
+    *params.getRawParameterValue("gain") = 12.0f;
+    processor.processBlock(buffer, midiBuffer);
+    const auto rampLevel = buffer.getMagnitude(0, 0, 512);
+    REQUIRE(buffer.getSample(0, 0) == Catch::Approx(lastQuietSample).margin(quietLevel * 0.1f));
+
+    for (int block = 0; block < 10; ++block)
+        processor.processBlock(buffer, midiBuffer);
+
+    const auto loudLevel = buffer.getMagnitude(0, 0, 512);
+    REQUIRE(rampLevel > quietLevel);
+    REQUIRE(rampLevel < loudLevel * 0.5f);
+    REQUIRE(loudLevel > quietLevel * 10.0f);
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Parameter Batch Test", "[processor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    // Offline processing skips the render cache, so both processors synthesise every block
+    DualToneGeneratorAudioProcessor batched;
+    DualToneGeneratorAudioProcessor reference;
+    juce::AudioBuffer<float> batchedBuffer(2, 512);
+    juce::AudioBuffer<float> referenceBuffer(2, 512);
+    juce::MidiBuffer midiBuffer;
+
+    for (auto* processor : { &batched, &reference })
+    {
+        auto& params = processor->getValueTreeState();
+        *params.getRawParameterValue("spread") = 0.0f;
+        *params.getRawParameterValue("gain") = -12.0f;
+        processor->setNonRealtime(true);
+        processor->prepareToPlay(44100.0, 512);
+    }
+
+    auto processBoth = [&]
+    {
+        batched.processBlock(batchedBuffer, midiBuffer);
+        reference.processBlock(referenceBuffer, midiBuffer);
+
+        auto difference = 0.0f;
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int sample = 0; sample < 512; ++sample)
+                difference = juce::jmax(difference, std::abs(batchedBuffer.getSample(channel, sample) - referenceBuffer.getSample(channel, sample)));
+
+        return difference;
+    };
+
+    auto setTone = [](DualToneGeneratorAudioProcessor& processor)
+    {
+        auto& params = processor.getValueTreeState();
+        *params.getRawParameterValue("centerFreq") = 300.0f;
+        *params.getRawParameterValue("gain") = 12.0f;
+    };
+
+    REQUIRE(processBoth() == 0.0f);
+
+    {
+        // Nothing set inside the batch reaches the audio thread before the batch ends
+        const auto batch = batched.batchParameterChanges();
+        setTone(batched);
+        REQUIRE(processBoth() == 0.0f);
+        REQUIRE(processBoth() == 0.0f);
+    }
+
+    // Then every change lands in the same block, exactly as if they had been set together just now
+    setTone(reference);
+    REQUIRE(processBoth() == 0.0f);
+    const auto rampLevel = batchedBuffer.getMagnitude(0, 0, 512);
+
+    for (int block = 0; block < 10; ++block)
+        REQUIRE(processBoth() == 0.0f);
+
+    REQUIRE(batchedBuffer.getMagnitude(0, 0, 512) > rampLevel);
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Zero Spread Test", "[processor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    auto& params = processor.getValueTreeState();
+    *params.getRawParameterValue("spread") = 0.0f;
+    *params.getRawParameterValue("pan1") = -1.0f;
+    *params.getRawParameterValue("pan2") = 1.0f;
+    processor.prepareToPlay(44100.0, 512);
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midiBuffer;
+    processor.processBlock(buffer, midiBuffer);
+
+    // Both oscillators start in phase, so the single-tone kernel must give identical hard-panned channels
+    REQUIRE(buffer.getMagnitude(0, 0, 512) > 0.01f);
+    for (int i = 0; i < 512; ++i)
+        REQUIRE(buffer.getSample(0, i) == Catch::Approx(buffer.getSample(1, i)).margin(1.0e-6));
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Surround Layout Test", "[processor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    juce::AudioProcessor::BusesLayout layout;
+    layout.outputBuses.add(juce::AudioChannelSet::create5point1());
+    REQUIRE(processor.setBusesLayout(layout));
+
+    auto& params = processor.getValueTreeState();
+    *params.getRawParameterValue("pan1") = -1.0f;
+    *params.getRawParameterValue("pan2") = 1.0f;
+    processor.prepareToPlay(48000.0, 1024);
+
+    juce::AudioBuffer<float> buffer(6, 1024);
+    juce::MidiBuffer midiBuffer;
+    processor.processBlock(buffer, midiBuffer);
+
+    // 5.1 order is L, R, C, LFE, Ls, Rs; hard-panned tones sit between each front and surround speaker
+    REQUIRE(buffer.getMagnitude(0, 0, 1024) > 0.01f);
+    REQUIRE(buffer.getMagnitude(1, 0, 1024) > 0.01f);
+    REQUIRE(buffer.getMagnitude(2, 0, 1024) == 0.0f);
+    REQUIRE(buffer.getMagnitude(3, 0, 1024) == 0.0f);
+    REQUIRE(buffer.getMagnitude(4, 0, 1024) > buffer.getMagnitude(0, 0, 1024));
+    REQUIRE(buffer.getMagnitude(5, 0, 1024) > buffer.getMagnitude(1, 0, 1024));
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor MIDI Voice Test", "[processor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    auto& params = processor.getValueTreeState();
+    *params.getRawParameterValue("voiceMode") = 1.0f; // MIDI
+    *params.getRawParameterValue("spread") = 0.0f;
+    processor.prepareToPlay(44100.0, 512);
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midiBuffer;
+    midiBuffer.addEvent(juce::MidiMessage::noteOn(1, 69, 1.0f), 100);
+    processor.processBlock(buffer, midiBuffer);
+
+    // The note starts on its own sample rather than at the block boundary
+    REQUIRE(buffer.getMagnitude(0, 0, 100) == 0.0f);
+    REQUIRE(buffer.getMagnitude(0, 100, 412) > 0.01f);
+
+    midiBuffer.addEvent(juce::MidiMessage::noteOff(1, 69), 0);
+    processor.processBlock(buffer, midiBuffer);
+
+    // Once the release has run out the voice is back in the pool and the output is silent
+    for (int block = 0; block < 10; ++block)
+        processor.processBlock(buffer, midiBuffer);
+
+    REQUIRE(buffer.getMagnitude(0, 0, 512) == 0.0f);
+    REQUIRE(buffer.getMagnitude(1, 0, 512) == 0.0f);
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Tone Bank Test", "[processor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto render = [](DualToneGeneratorAudioProcessor& processor)
+    {
+        processor.prepareToPlay(44100.0, 512);
+        juce::AudioBuffer<float> buffer(2, 512);
+        juce::MidiBuffer midiBuffer;
+        processor.processBlock(buffer, midiBuffer);
+        return buffer;
+    };
+
+    // The default Center/Spread pair and the same pair expressed as a two-partial bank must sound the same
+    DualToneGeneratorAudioProcessor pair;
+    DualToneGeneratorAudioProcessor bank;
+    bank.setToneBank(ToneBankLayout::dualTone(2.0, 1.0, 1.0, -1.0, 1.0));
+
+    const auto pairOutput = render(pair);
+    const auto bankOutput = render(bank);
+
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 512; ++i)
+            REQUIRE(bankOutput.getSample(ch, i) == Catch::Approx(pairOutput.getSample(ch, i)).margin(1.0e-5));
+
+    // A wider bank survives a state round trip
+    ToneBankLayout chord;
+    chord.numPartials = 16;
+    for (int partial = 0; partial < chord.numPartials; ++partial)
+    {
+        chord.offsetsHz[partial] = 7.5 * partial;
+        chord.levels[partial] = 0.25;
+        chord.pans[partial] = -1.0 + 2.0 * partial / (chord.numPartials - 1);
+    }
+    bank.setToneBank(chord);
+
+    juce::MemoryBlock state;
+    bank.getStateInformation(state);
+    DualToneGeneratorAudioProcessor restored;
+    restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+    DualToneGeneratorAudioProcessor reference;
+    reference.setToneBank(chord);
+
+    const auto restoredOutput = render(restored);
+    const auto referenceOutput = render(reference);
+
+    REQUIRE(referenceOutput.getMagnitude(0, 0, 512) > 0.01f);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 512; ++i)
+            REQUIRE(restoredOutput.getSample(ch, i) == Catch::Approx(referenceOutput.getSample(ch, i)).margin(1.0e-5));
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Binary State Test", "[state]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto setParameter = [](DualToneGeneratorAudioProcessor& processor, const char* parameterID, float value)
+    {
+        auto* parameter = processor.getValueTreeState().getParameter(parameterID);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    };
+
+    auto getParameter = [](DualToneGeneratorAudioProcessor& processor, const char* parameterID)
+    {
+        return processor.getValueTreeState().getRawParameterValue(parameterID)->load();
+    };
+
+    DualToneGeneratorAudioProcessor source;
+    setParameter(source, "centerFreq", 312.5f);
+    setParameter(source, "spread", 4.25f);
+    setParameter(source, "drive", 3.0f);
+    setParameter(source, "oversampling", 2.0f);
+    setParameter(source, "voiceMode", 1.0f);
+
+    ToneBankLayout chord;
+    chord.numPartials = 5;
+    for (int partial = 0; partial < chord.numPartials; ++partial)
+    {
+        chord.offsetsHz[partial] = 12.5 * partial;
+        chord.levels[partial] = 0.5;
+        chord.pans[partial] = 0.25 * partial - 0.5;
+    }
+    source.setToneBank(chord);
+
+    juce::MemoryBlock state;
+    source.getStateInformation(state);
+    REQUIRE(PluginState::isBinary(state.getData(), state.getSize()));
+
+    // The layout itself round trips exactly
+    PluginState decoded;
+    REQUIRE(decoded.readBinary(state.getData(), state.getSize()));
+    REQUIRE(decoded.values[0] == Catch::Approx(312.5f));
+    REQUIRE(decoded.toneBank.numPartials == chord.numPartials);
+
+    for (int partial = 0; partial < chord.numPartials; ++partial)
+    {
+        REQUIRE(decoded.toneBank.offsetsHz[partial] == chord.offsetsHz[partial]);
+        REQUIRE(decoded.toneBank.levels[partial] == chord.levels[partial]);
+        REQUIRE(decoded.toneBank.pans[partial] == chord.pans[partial]);
+    }
+
+    DualToneGeneratorAudioProcessor restored;
+    restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+    for (const auto* parameterID : PluginState::parameterIDs)
+        REQUIRE(getParameter(restored, parameterID) == Catch::Approx(getParameter(source, parameterID)));
+
+    juce::MemoryBlock resaved;
+    restored.getStateInformation(resaved);
+    REQUIRE(resaved.getSize() == state.getSize());
+
+    // Sessions from before the binary format still load through the XML fallback, tone bank included
+    juce::MemoryBlock legacyState;
+    auto xml = source.getValueTreeState().copyState().createXml();
+    REQUIRE(xml != nullptr);
+    juce::AudioProcessor::copyXmlToBinary(*xml, legacyState);
+
+    DualToneGeneratorAudioProcessor legacy;
+    legacy.setStateInformation(legacyState.getData(), static_cast<int>(legacyState.getSize()));
+
+    for (const auto* parameterID : PluginState::parameterIDs)
+        REQUIRE(getParameter(legacy, parameterID) == Catch::Approx(getParameter(source, parameterID)));
+
+    juce::MemoryBlock legacyResaved;
+    legacy.getStateInformation(legacyResaved);
+    REQUIRE(legacyResaved.getSize() == state.getSize());
+
+    // Truncated data and data from a newer format version are ignored
+    DualToneGeneratorAudioProcessor untouched;
+    untouched.setStateInformation(state.getData(), static_cast<int>(state.getSize()) - 1);
+    REQUIRE(getParameter(untouched, "centerFreq") == Catch::Approx(100.0f));
+
+    juce::MemoryBlock newer(state);
+    static_cast<char*>(newer.getData())[4] = static_cast<char>(PluginState::formatVersion + 1);
+    untouched.setStateInformation(newer.getData(), static_cast<int>(newer.getSize()));
+    REQUIRE(getParameter(untouched, "centerFreq") == Catch::Approx(100.0f));
+
+    // Data saved before Morph was appended leaves it at its default
+    PluginState older;
+    older.values.fill(0.0f);
+    older.values[PluginState::centerFreq] = 250.0f;
+    older.values[PluginState::voiceMode] = 1.0f;
+    juce::MemoryBlock olderState;
+    older.writeBinary(olderState);
+
+    auto* olderBytes = static_cast<char*>(olderState.getData());
+    olderBytes[8] = static_cast<char>(PluginState::morph);
+    olderState.setSize(olderState.getSize() - sizeof(float));
+
+    DualToneGeneratorAudioProcessor upgraded;
+    setParameter(upgraded, "morph", 0.75f);
+    upgraded.setStateInformation(olderState.getData(), static_cast<int>(olderState.getSize()));
+    REQUIRE(getParameter(upgraded, "centerFreq") == Catch::Approx(250.0f));
+    REQUIRE(getParameter(upgraded, "voiceMode") == 1.0f);
+    REQUIRE(getParameter(upgraded, "morph") == 0.0f);
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Preset Bank Test", "[state]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    processor.prepareToPlay(44100.0, 256);
+
+    auto* centerFrequency = processor.getValueTreeState().getParameter("centerFreq");
+    auto* rawCenterFrequency = processor.getValueTreeState().getRawParameterValue("centerFreq");
+
+    REQUIRE(processor.getNumPrograms() == 1);
+    REQUIRE(processor.getProgramName(0) == "Init");
+
+    centerFrequency->setValueNotifyingHost(centerFrequency->convertTo0to1(200.0f));
+    REQUIRE(processor.addProgram("Low") == 1);
+
+    ToneBankLayout chord;
+    chord.numPartials = 3;
+    chord.offsetsHz[1] = 5.0;
+    chord.offsetsHz[2] = 10.0;
+    chord.levels[0] = chord.levels[1] = chord.levels[2] = 0.5;
+    processor.setToneBank(chord);
+    centerFrequency->setValueNotifyingHost(centerFrequency->convertTo0to1(400.0f));
+    REQUIRE(processor.addProgram("Chord") == 2);
+
+    REQUIRE(processor.getNumPrograms() == 3);
+    processor.changeProgramName(1, "Low Pair");
+    REQUIRE(processor.getProgramName(1) == "Low Pair");
+
+    // The host's program change reaches the parameters straight away
+    processor.setCurrentProgram(0);
+    REQUIRE(processor.getCurrentProgram() == 0);
+    REQUIRE(rawCenterFrequency->load() == Catch::Approx(100.0f));
+
+    // A MIDI program change is applied whole at the start of the next block. The engine plays the
+    // preset from there on, while the parameters are left to the message thread
+    juce::AudioBuffer<float> buffer(2, 256);
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::programChange(1, 2), 128);
+    processor.processBlock(buffer, midi);
+    REQUIRE_FALSE(processor.isToneBankActive());
+
+    midi.clear();
+    processor.processBlock(buffer, midi);
+    REQUIRE(processor.isToneBankActive());
+    REQUIRE(processor.getCurrentProgram() == 2);
+    REQUIRE(rawCenterFrequency->load() == Catch::Approx(100.0f));
+
+    // The switched-to values and tone bank reach the parameters before anything is saved
+    juce::MemoryBlock state;
+    processor.getStateInformation(state);
+    REQUIRE(rawCenterFrequency->load() == Catch::Approx(400.0f));
+
+    PluginState saved;
+    REQUIRE(saved.readBinary(state.getData(), state.getSize()));
+    REQUIRE(saved.values[0] == Catch::Approx(400.0f));
+    REQUIRE(saved.toneBank.numPartials == 3);
+    REQUIRE(saved.toneBank.offsetsHz[2] == 10.0);
+
+    // Programs outside the bank are ignored
+    processor.setCurrentProgram(PresetBank::maxPresets);
+    REQUIRE(processor.getCurrentProgram() == 2);
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Morph Test", "[morph]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto makeState = [](float center, float spread, float pan1, float pan2, float atten2, float gain, float drive, float type)
+    {
+        PluginState state;
+        state.values[PluginState::centerFreq] = center;
+        state.values[PluginState::spread] = spread;
+        state.values[PluginState::pan1] = pan1;
+        state.values[PluginState::pan2] = pan2;
+        state.values[PluginState::atten1] = -6.0f;
+        state.values[PluginState::atten2] = atten2;
+        state.values[PluginState::gain] = gain;
+        state.values[PluginState::drive] = drive;
+        state.values[PluginState::shapeType] = type;
+        return state;
+    };
+
+    const auto low = makeState(200.0f, 3.0f, -0.5f, 0.5f, 0.0f, 0.0f, -24.0f, 0.0f);
+    const auto high = makeState(400.0f, 10.0f, 1.0f, -1.0f, -12.0f, 6.0f, 6.0f, 1.0f);
+    const auto middle = makeState(300.0f, 6.0f, 0.0f, 0.0f, -3.0f, -3.0f, 0.0f, 0.5f);
+
+    auto render = [](DualToneGeneratorAudioProcessor& processor, int numBlocks, float morphAfterFirstBlock)
+    {
+        processor.prepareToPlay(44100.0, 256);
+        juce::AudioBuffer<float> output(2, 256 * numBlocks);
+        juce::AudioBuffer<float> block(2, 256);
+        juce::MidiBuffer midi;
+
+        for (int index = 0; index < numBlocks; ++index)
+        {
+            if (index == 1 && morphAfterFirstBlock >= 0.0f)
+                *processor.getValueTreeState().getRawParameterValue("morph") = morphAfterFirstBlock;
+
+            processor.processBlock(block, midi);
+
+            for (int ch = 0; ch < 2; ++ch)
+                output.copyFrom(ch, 256 * index, block, ch, 0, 256);
+        }
+
+        return output;
+    };
+
+    auto renderState = [&render](const PluginState& state)
+    {
+        DualToneGeneratorAudioProcessor processor;
+
+        for (int index = 0; index < PluginState::numParameters; ++index)
+            *processor.getValueTreeState().getRawParameterValue(PluginState::parameterIDs[index]) = state.values[static_cast<size_t>(index)];
+
+        return render(processor, 4, -1.0f);
+    };
+
+    auto renderMorph = [&render](const std::vector<PluginState>& states, float position, int numBlocks, float morphAfterFirstBlock)
+    {
+        DualToneGeneratorAudioProcessor processor;
+        processor.setMorphStates(states);
+        *processor.getValueTreeState().getRawParameterValue("morph") = position;
+        return render(processor, numBlocks, morphAfterFirstBlock);
+    };
+
+    auto requireSame = [](const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference)
+    {
+        REQUIRE(reference.getMagnitude(0, 0, reference.getNumSamples()) > 0.01f);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < reference.getNumSamples(); ++i)
+                REQUIRE(output.getSample(ch, i) == Catch::Approx(reference.getSample(ch, i)).margin(1.0e-4));
+    };
+
+    // On a state the morph plays exactly that state's settings
+    requireSame(renderMorph({ low, high }, 0.0f, 4, -1.0f), renderState(low));
+    requireSame(renderMorph({ low, high }, 1.0f, 4, -1.0f), renderState(high));
+    requireSame(renderMorph({ low, middle, high }, 0.5f, 4, -1.0f), renderState(middle));
+
+    // A morph from one end to the other glides without a step: no sample moves further than
+    // the fastest-moving state does on its own
+    auto getLargestStep = [](const juce::AudioBuffer<float>& output)
+    {
+        auto largest = 0.0f;
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 1; i < output.getNumSamples(); ++i)
+                largest = juce::jmax(largest, std::abs(output.getSample(ch, i) - output.getSample(ch, i - 1)));
+
+        return largest;
+    };
+
+    const auto glide = renderMorph({ low, middle, high }, 0.0f, 16, 1.0f);
+    const auto largestStateStep = juce::jmax(getLargestStep(renderState(low)),
+                                             getLargestStep(renderState(middle)),
+                                             getLargestStep(renderState(high)));
+    REQUIRE(getLargestStep(glide) < 1.5f * largestStateStep);
+
+    // Morphing through programs needs every program to exist; fewer than two states hand control back
+    DualToneGeneratorAudioProcessor processor;
+    REQUIRE_FALSE(processor.setMorphPrograms({ 0, 5 }));
+    REQUIRE(processor.setMorphPrograms({ 0, 0 }));
+    processor.setMorphStates({ high });
+
+    for (int index = 0; index < PluginState::numParameters; ++index)
+        *processor.getValueTreeState().getRawParameterValue(PluginState::parameterIDs[index]) = low.values[static_cast<size_t>(index)];
+
+    requireSame(render(processor, 4, -1.0f), renderState(low));
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Precision Test", "[processor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor floatProcessor;
+    DualToneGeneratorAudioProcessor doubleProcessor;
+    REQUIRE(doubleProcessor.supportsDoublePrecisionProcessing());
+
+    for (auto* processor : { &floatProcessor, &doubleProcessor })
+    {
+        auto& params = processor->getValueTreeState();
+        *params.getRawParameterValue("centerFreq") = 517.3f;
+        *params.getRawParameterValue("drive") = 6.0f;
+        *params.getRawParameterValue("shapeType") = 0.4f;
+        processor->prepareToPlay(48000.0, 4096);
+    }
+
+    juce::AudioBuffer<float> floatBuffer(2, 4096);
+    juce::AudioBuffer<double> doubleBuffer(2, 4096);
+    juce::MidiBuffer midiBuffer;
+    floatProcessor.processBlock(floatBuffer, midiBuffer);
+    doubleProcessor.processBlock(doubleBuffer, midiBuffer);
+
+    // The float kernels must track the double reference well below anything audible
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 4096; ++i)
+            REQUIRE(floatBuffer.getSample(ch, i) == Catch::Approx(doubleBuffer.getSample(ch, i)).margin(1.0e-5));
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessor Load Meter Test", "[load]")
+{
+    // The processor times every block it processes
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    processor.prepareToPlay(44100.0, 512);
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midiBuffer;
+
+    for (int block = 0; block < 20; ++block)
+        processor.processBlock(buffer, midiBuffer);
+
+    const auto stats = processor.getLoadMeter().getStats();
+    REQUIRE(stats.numBlocks == 20);
+    REQUIRE(stats.peakPercent > 0.0);
+    REQUIRE(stats.p99Percent <= stats.peakPercent);
+    REQUIRE(stats.meanPercent <= stats.peakPercent);
+}
+
+TEST_CASE("AudioScopeFifo Decimation Test", "[scope]")
+{
+    AudioScopeFifo fifo;
+    fifo.prepare(48000.0);
+    REQUIRE(fifo.getOutputSampleRate() == Catch::Approx(12000.0));
+
+    juce::AudioBuffer<float> buffer(2, 400);
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+    {
+        buffer.setSample(0, i, 1.0f);
+        buffer.setSample(1, i, 0.5f);
+    }
+
+    // Nothing is written until the consumer switches the FIFO on
+    fifo.push(buffer);
+    float popped[AudioScopeFifo::capacity];
+    REQUIRE(fifo.pop(popped, AudioScopeFifo::capacity) == 0);
+
+    // One output sample per four input samples; once the filter has filled, a constant comes out
+    // as the mean of the front pair
+    fifo.setActive(true);
+    fifo.push(buffer);
+    REQUIRE(fifo.pop(popped, AudioScopeFifo::capacity) == 100);
+    for (int i = AudioScopeFifo::tapsPerOutput; i < 100; ++i)
+        REQUIRE(popped[i] == Catch::Approx(0.75f).margin(1.0e-4));
+
+    // A tone inside the scope's band passes at its level, while one above the decimated Nyquist
+    // rate is filtered out instead of folding down onto 1 kHz
+    auto getSettledPeak = [&fifo, &popped](double frequency)
+    {
+        juce::AudioBuffer<float> tone(2, 4800);
+        for (int i = 0; i < tone.getNumSamples(); ++i)
+            for (int ch = 0; ch < 2; ++ch)
+                tone.setSample(ch, i, static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * i / 48000.0)));
+
+        fifo.push(tone);
+        const auto count = fifo.pop(popped, AudioScopeFifo::capacity);
+        REQUIRE(count == 1200);
+
+        auto peak = 0.0f;
+        for (int i = AudioScopeFifo::tapsPerOutput; i < count; ++i)
+            peak = std::max(peak, std::abs(popped[i]));
+
+        return peak;
+    };
+
+    REQUIRE(getSettledPeak(1000.0) == Catch::Approx(1.0f).margin(0.01f));
+    REQUIRE(getSettledPeak(11000.0) < 1.0e-3f);
+
+    // A consumer that falls behind loses the newest samples, and the producer never blocks
+    juce::AudioBuffer<float> longBuffer(1, AudioScopeFifo::capacity * 8);
+    longBuffer.clear();
+    fifo.push(longBuffer);
+    REQUIRE(fifo.pop(popped, AudioScopeFifo::capacity) == AudioScopeFifo::capacity);
+    REQUIRE(fifo.pop(popped, AudioScopeFifo::capacity) == 0);
+}
+
+TEST_CASE("KnobImageAtlas Frame Test", "[editor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::DrawablePath marker;
+    juce::Path pointer;
+    pointer.addEllipse(0.0f, 0.0f, 100.0f, 100.0f);
+    pointer.addRectangle(47.0f, 0.0f, 6.0f, 40.0f);
+    marker.setPath(pointer);
+    marker.setFill(juce::Colours::black);
+
+    KnobImageAtlas atlas(&marker);
+    KnobImageAtlas::Geometry geometry;
+    geometry.bounds = { 0, 0, 120, 120 };
+    geometry.rotaryStartAngle = juce::degreesToRadians(225.0f);
+    geometry.rotaryEndAngle = juce::degreesToRadians(495.0f);
+    geometry.outlineColour = juce::Colours::grey;
+    geometry.accentColour = juce::Colours::red;
+
+    auto render = [&](float sliderPos)
+    {
+        juce::Image image(juce::Image::ARGB, 160, 160, true, juce::SoftwareImageType());
+        juce::Graphics g(image);
+        g.setOrigin({ 20, 20 });
+        atlas.draw(g, geometry, sliderPos);
+        return image;
+    };
+
+    auto identical = [](const juce::Image& a, const juce::Image& b)
+    {
+        const juce::Image::BitmapData first(a, juce::Image::BitmapData::readOnly);
+        const juce::Image::BitmapData second(b, juce::Image::BitmapData::readOnly);
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (first.getPixelColour(x, y) != second.getPixelColour(x, y))
+                    return false;
+
+        return true;
+    };
+
+    // Returning to a position reuses the frame it rendered the first time
+    const auto first = render(0.3f);
+    const auto other = render(0.7f);
+    REQUIRE(! identical(first, other));
+    REQUIRE(identical(first, render(0.3f)));
+
+    // A resize builds a new set of layers rather than stretching the old one
+    geometry.bounds = { 0, 0, 80, 80 };
+    REQUIRE(! identical(first, render(0.3f)));
+
+    // A knob too large for the budget to hold every frame evicts one frame at a time, so the
+    // frames stay close to the budget rather than being dropped all at once
+    KnobImageAtlas largeAtlas(&marker);
+    geometry.bounds = { 0, 0, 600, 600 };
+    geometry.pixelScale = 2.0f;
+    juce::Image largeImage(juce::Image::ARGB, 1200, 1200, true, juce::SoftwareImageType());
+    juce::Graphics largeGraphics(largeImage);
+    largeGraphics.addTransform(juce::AffineTransform::scale(2.0f));
+
+    size_t filledBytes = 0;
+
+    for (int step = 0; step <= 16; ++step)
+    {
+        largeAtlas.draw(largeGraphics, geometry, static_cast<float>(step) / 16.0f);
+        const auto bytes = largeAtlas.getCachedFrameBytes();
+        REQUIRE(bytes <= KnobImageAtlas::frameBudgetBytes);
+        REQUIRE(bytes >= filledBytes);
+        filledBytes = bytes;
+    }
+
+    REQUIRE(filledBytes > KnobImageAtlas::frameBudgetBytes / 2);
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessorEditor Open Latency Test", "[editor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto timeEditorOpen = [](DualToneGeneratorAudioProcessor& processor)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+
+        // Opening includes the first paint, which builds the static layer and the dial rasters
+        const auto snapshot = editor->createComponentSnapshot(editor->getLocalBounds());
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        REQUIRE(snapshot.isValid());
+        return elapsed * 1000.0;
+    };
+
+    DualToneGeneratorAudioProcessor first;
+    juce::SharedResourcePointer<EditorAssets> assets;
+    const auto parsedBefore = assets->getNumParsed();
+
+    const auto coldMs = timeEditorOpen(first);
+    const auto parsedByFirstEditor = assets->getNumParsed();
+    REQUIRE(parsedByFirstEditor > parsedBefore);
+
+    // Reopening, and opening another instance's editor, parse nothing and reuse the rasters
+    const auto reopenMs = timeEditorOpen(first);
+    DualToneGeneratorAudioProcessor second;
+    const auto secondInstanceMs = timeEditorOpen(second);
+    REQUIRE(assets->getNumParsed() == parsedByFirstEditor);
+
+    WARN("Editor open: first " << coldMs << " ms, reopen " << reopenMs << " ms, second instance "
+                               << secondInstanceMs << " ms");
+}
+
+TEST_CASE("DualToneGeneratorAudioProcessorEditor Static Label Test", "[editor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+    auto* toneEditor = dynamic_cast<DualToneGeneratorAudioProcessorEditor*>(editor.get());
+    REQUIRE(toneEditor != nullptr);
+
+    auto findLabel = [&editor](const juce::String& text) -> juce::Label*
+    {
+        for (auto* child : editor->getChildren())
+            if (auto* label = dynamic_cast<juce::Label*>(child); label != nullptr && label->getText() == text)
+                return label;
+
+        return nullptr;
+    };
+
+    // Labels painted into the cached background stay visible, so screen readers still find them
+    for (auto enabled : { true, false })
+    {
+        toneEditor->setStaticLayerCachingEnabled(enabled);
+
+        for (const auto* text : { "CENTER", "SPREAD", "TONE 1", "TONE 2" })
+        {
+            auto* label = findLabel(text);
+            REQUIRE(label != nullptr);
+            REQUIRE(label->isVisible());
+            REQUIRE(label->getAccessibilityHandler() != nullptr);
+        }
+    }
+}
@@ -0,0 +1,359 @@
+#include <catch2/catch_test_macros.hpp>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "DualToneC.h"
+#include "PluginProcessor.h"
+#include "RealtimeSafety.h"
+
+#include <mutex>
+#include <vector>
+
+// Every processBlock call here runs with the RealtimeSafety hooks armed, so any allocation,
+// lock, sleep or file access on the audio path fails the test with the name of the call.
+// Everything around the call (parameter changes, state loads, prepare, layout changes) is the
+// host's message thread and may allocate.
+namespace
+{
+template <typename SampleType>
+void processChecked(DualToneGeneratorAudioProcessor& processor,
+                    juce::AudioBuffer<SampleType>& buffer,
+                    juce::MidiBuffer& midi)
+{
+    RealtimeSafety::takeReport();
+
+    {
+        RealtimeSafety::ScopedAudioCallback audioCallback;
+        processor.processBlock(buffer, midi);
+    }
+
+    const auto report = RealtimeSafety::takeReport();
+    INFO("first violation: " << report.firstViolation);
+    REQUIRE(report.numViolations == 0);
+    midi.clear();
+}
+
+void setParameter(DualToneGeneratorAudioProcessor& processor, const char* parameterID, float value)
+{
+    *processor.getValueTreeState().getRawParameterValue(parameterID) = value;
+}
+
+// A few blocks for every combination of shaping, oversampling and voice mode, with the
+// continuous parameters moving every block so the ramps and table requests stay busy.
+template <typename SampleType>
+void sweepParameters(DualToneGeneratorAudioProcessor& processor, int numChannels, int blockSize)
+{
+    juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    auto step = 0;
+
+    for (auto voiceMode : { 0.0f, 1.0f })
+    {
+        setParameter(processor, "voiceMode", voiceMode);
+
+        for (auto shapeMode : { 0.0f, 1.0f })
+        {
+            setParameter(processor, "shapeMode", shapeMode);
+
+            for (auto oversampling : { 0.0f, 1.0f, 2.0f, 3.0f })
+            {
+                setParameter(processor, "oversampling", oversampling);
+
+                for (int block = 0; block < 8; ++block, ++step)
+                {
+                    const auto position = static_cast<float>(step % 16) / 15.0f;
+                    setParameter(processor, "centerFreq", 60.0f + 540.0f * position);
+                    setParameter(processor, "spread", 20.0f * (1.0f - position));
+                    setParameter(processor, "pan1", 2.0f * position - 1.0f);
+                    setParameter(processor, "atten2", -24.0f * position);
+                    setParameter(processor, "gain", 12.0f * position - 6.0f);
+                    setParameter(processor, "drive", 36.0f * position - 24.0f);
+                    setParameter(processor, "shapeType", position);
+
+                    if (voiceMode > 0.0f)
+                    {
+                        const auto note = 48 + step % 24;
+                        midi.addEvent(juce::MidiMessage::noteOn(1, note, 0.8f), 0);
+                        midi.addEvent(juce::MidiMessage::noteOff(1, note), blockSize / 2);
+                    }
+
+                    processChecked(processor, buffer, midi);
+                }
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void processHeld(DualToneGeneratorAudioProcessor& processor, int numChannels, int blockSize, int numBlocks)
+{
+    juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    for (int block = 0; block < numBlocks; ++block)
+        processChecked(processor, buffer, midi);
+}
+} // namespace
+
+TEST_CASE("Realtime Safety Hooks Test", "[realtime]")
+{
+    // The harness has to see a violation before a clean run means anything
+    {
+        RealtimeSafety::ScopedAudioCallback audioCallback;
+        std::vector<float> allocated(64);
+    }
+
+    const auto report = RealtimeSafety::takeReport();
+    REQUIRE(report.numViolations > 0);
+    REQUIRE(juce::String(report.firstViolation).startsWith("operator new"));
+
+    if (RealtimeSafety::canCheckSystemCalls())
+    {
+        std::mutex mutex;
+
+        {
+            RealtimeSafety::ScopedAudioCallback audioCallback;
+            const std::lock_guard<std::mutex> lock(mutex);
+        }
+
+        REQUIRE(juce::String(RealtimeSafety::takeReport().firstViolation) == "pthread_mutex_lock");
+    }
+}
+
+TEST_CASE("Realtime Safety Parameter Sweep Test", "[realtime]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    for (auto doublePrecision : { false, true })
+    {
+        DualToneGeneratorAudioProcessor processor;
+        processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                         : juce::AudioProcessor::singlePrecision);
+        processor.prepareToPlay(48000.0, 512);
+
+        if (doublePrecision)
+            sweepParameters<double>(processor, 2, 512);
+        else
+            sweepParameters<float>(processor, 2, 512);
+
+        // A still setting long enough for the render cache to publish a period and play from it
+        setParameter(processor, "voiceMode", 0.0f);
+        setParameter(processor, "oversampling", 0.0f);
+
+        for (int wait = 0; wait < 40; ++wait)
+        {
+            if (doublePrecision)
+                processHeld<double>(processor, 2, 512, 1);
+            else
+                processHeld<float>(processor, 2, 512, 1);
+
+            juce::Thread::sleep(10);
+        }
+    }
+}
+
+TEST_CASE("Realtime Safety State Load Test", "[realtime]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor source;
+    juce::MemoryBlock pairState;
+    setParameter(source, "centerFreq", 220.0f);
+    setParameter(source, "drive", 6.0f);
+    source.getStateInformation(pairState);
+
+    ToneBankLayout chord;
+    chord.numPartials = 24;
+    for (int partial = 0; partial < chord.numPartials; ++partial)
+    {
+        chord.offsetsHz[partial] = 5.0 * partial;
+        chord.levels[partial] = 0.2;
+        chord.pans[partial] = -1.0 + 2.0 * partial / (chord.numPartials - 1);
+    }
+
+    juce::MemoryBlock bankState;
+    source.setToneBank(chord);
+    source.getStateInformation(bankState);
+
+    DualToneGeneratorAudioProcessor processor;
+    processor.prepareToPlay(44100.0, 256);
+
+    // A host may load state between any two callbacks; the audio thread picks it up lock-free
+    for (int load = 0; load < 6; ++load)
+    {
+        const auto& state = load % 2 == 0 ? bankState : pairState;
+        processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        processHeld<float>(processor, 2, 256, 4);
+    }
+}
+
+TEST_CASE("Realtime Safety Preset Switch Test", "[realtime]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    setParameter(processor, "drive", 6.0f);
+    processor.addProgram("Pair");
+
+    ToneBankLayout chord;
+    chord.numPartials = ToneBankLayout::maxPartials;
+    for (int partial = 0; partial < chord.numPartials; ++partial)
+    {
+        chord.offsetsHz[partial] = 2.5 * partial;
+        chord.levels[partial] = 0.1;
+    }
+
+    processor.setToneBank(chord);
+    setParameter(processor, "centerFreq", 330.0f);
+    processor.addProgram("Chord");
+    processor.prepareToPlay(48000.0, 128);
+
+    // Program changes arrive as MIDI on the audio thread, mid-block, and from the host between blocks
+    juce::AudioBuffer<float> buffer(2, 128);
+    juce::MidiBuffer midi;
+
+    for (int block = 0; block < 16; ++block)
+    {
+        if (block % 4 == 1)
+            midi.addEvent(juce::MidiMessage::programChange(1, block % 3), 64);
+        else if (block % 4 == 3)
+            processor.setCurrentProgram(block % 3);
+
+        processChecked(processor, buffer, midi);
+    }
+}
+
+TEST_CASE("Realtime Safety Morph Test", "[realtime]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    std::vector<PluginState> states(3);
+    const float drives[] = { -24.0f, 6.0f, 12.0f };
+
+    for (size_t index = 0; index < states.size(); ++index)
+    {
+        states[index].values[PluginState::centerFreq] = 150.0f + 150.0f * static_cast<float>(index);
+        states[index].values[PluginState::spread] = 4.0f * static_cast<float>(index);
+        states[index].values[PluginState::pan1] = static_cast<float>(index) - 1.0f;
+        states[index].values[PluginState::drive] = drives[index];
+        states[index].values[PluginState::shapeType] = 0.5f * static_cast<float>(index);
+    }
+
+    DualToneGeneratorAudioProcessor processor;
+    processor.setMorphStates(states);
+    processor.prepareToPlay(48000.0, 256);
+
+    // The morph sweeps back and forth across every state, in both shaping modes and with oversampling
+    for (auto shapeMode : { 0.0f, 1.0f })
+    {
+        setParameter(processor, "shapeMode", shapeMode);
+
+        for (auto oversampling : { 0.0f, 2.0f })
+        {
+            setParameter(processor, "oversampling", oversampling);
+
+            for (int step = 0; step < 12; ++step)
+            {
+                setParameter(processor, "morph", static_cast<float>(step % 5) / 4.0f);
+                processHeld<float>(processor, 2, 256, 2);
+                processHeld<double>(processor, 2, 256, 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("Realtime Safety Prepare Release Test", "[realtime]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    setParameter(processor, "oversampling", 2.0f);
+    setParameter(processor, "drive", 12.0f);
+
+    const struct
+    {
+        double sampleRate;
+        int blockSize;
+    } configurations[] = { { 44100.0, 64 }, { 96000.0, 1024 }, { 48000.0, 4096 }, { 192000.0, 128 }, { 44100.0, 64 } };
+
+    for (const auto& configuration : configurations)
+    {
+        processor.prepareToPlay(configuration.sampleRate, configuration.blockSize);
+        processHeld<float>(processor, 2, configuration.blockSize, 6);
+
+        // Hosts may hand over smaller blocks than announced
+        processHeld<float>(processor, 2, configuration.blockSize / 2 + 1, 2);
+        processor.releaseResources();
+    }
+}
+
+TEST_CASE("Realtime Safety Layout Change Test", "[realtime]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    DualToneGeneratorAudioProcessor processor;
+    setParameter(processor, "drive", 6.0f);
+    setParameter(processor, "shapeType", 0.5f);
+
+    const juce::AudioChannelSet layouts[] = { juce::AudioChannelSet::mono(),
+                                              juce::AudioChannelSet::stereo(),
+                                              juce::AudioChannelSet::create5point1(),
+                                              juce::AudioChannelSet::create7point1(),
+                                              juce::AudioChannelSet::ambisonic(1),
+                                              juce::AudioChannelSet::ambisonic(3),
+                                              juce::AudioChannelSet::stereo() };
+
+    for (const auto& channelSet : layouts)
+    {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.outputBuses.add(channelSet);
+        REQUIRE(processor.setBusesLayout(layout));
+
+        processor.prepareToPlay(48000.0, 512);
+        processHeld<float>(processor, channelSet.size(), 512, 4);
+        processHeld<double>(processor, channelSet.size(), 512, 2);
+        processor.releaseResources();
+    }
+}
+
+TEST_CASE("Realtime Safety C API Test", "[realtime]")
+{
+    // Everything after dualtone_create runs on the caller's thread, including the shaper table builds
+    auto* generator = dualtone_create(48000.0, 6);
+    REQUIRE(generator != nullptr);
+
+    constexpr int numFrames = 700;
+    std::vector<float> interleavedFloat(6 * numFrames);
+    std::vector<std::int16_t> interleavedShort(6 * numFrames);
+    std::vector<std::vector<std::uint8_t>> planarPacked(6, std::vector<std::uint8_t>(3 * numFrames));
+    void* channels[6];
+
+    for (int channel = 0; channel < 6; ++channel)
+        channels[channel] = planarPacked[static_cast<size_t>(channel)].data();
+
+    for (int step = 0; step < 16; ++step)
+    {
+        const auto position = static_cast<float>(step % 8) / 7.0f;
+
+        RealtimeSafety::takeReport();
+
+        {
+            RealtimeSafety::ScopedAudioCallback audioCallback;
+            dualtone_set_parameter(generator, DUALTONE_SHAPE_MODE, static_cast<float>(step / 8));
+            dualtone_set_parameter(generator, DUALTONE_OVERSAMPLING, static_cast<float>(step % 4));
+            dualtone_set_parameter(generator, DUALTONE_CENTER_FREQ, 60.0f + 540.0f * position);
+            dualtone_set_parameter(generator, DUALTONE_DRIVE, 36.0f * position - 24.0f);
+            dualtone_set_parameter(generator, DUALTONE_SHAPE_TYPE, position);
+            dualtone_set_parameter(generator, DUALTONE_PAN_1, 2.0f * position - 1.0f);
+
+            dualtone_render_interleaved(generator, interleavedFloat.data(), numFrames, DUALTONE_FLOAT32);
+            dualtone_render_interleaved(generator, interleavedShort.data(), numFrames, DUALTONE_INT16);
+            dualtone_render_planar(generator, channels, numFrames, DUALTONE_INT24);
+            dualtone_seek(generator, 48000 * step);
+        }
+
+        const auto report = RealtimeSafety::takeReport();
+        INFO("first violation: " << report.firstViolation);
+        REQUIRE(report.numViolations == 0);
+    }
+
+    dualtone_destroy(generator);
+}
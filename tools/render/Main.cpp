@@ -0,0 +1,191 @@
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include "OfflineRenderer.h"
+
+#include <iostream>
+
+// Headless renderer for long calibration and beat-tone files.
+//
+//     DualToneRender --out tones.wav --seconds 3600 [--rate 48000] [--channels 2] [--bits 24]
+//                    [--format wav|aiff] [--threads N] [--state preset.bin] [--set centerFreq=440 ...]
+//
+// --state loads a blob saved by the plugin, then each --set overrides one parameter by ID in the
+// parameter's own units. The output is identical for any --threads value. Rendering runs on the
+// engine alone, so no message manager or GUI is started.
+namespace
+{
+struct ParameterValue
+{
+    juce::String id;
+    float value = 0.0f;
+};
+
+// Index of the parameter in PluginState order, or -1 if there is no such parameter.
+int findParameter(const juce::String& parameterID)
+{
+    for (int index = 0; index < PluginState::numParameters; ++index)
+        if (parameterID == PluginState::parameterIDs[index])
+            return index;
+
+    return -1;
+}
+
+void printUsage()
+{
+    std::cerr << "Usage: DualToneRender --out <file> --seconds <duration> [--rate <Hz>] [--channels 1|2]\n"
+                 "                      [--bits 16|24|32] [--format wav|aiff] [--threads <count>]\n"
+                 "                      [--state <file>] [--set <parameterID>=<value> ...]\n";
+}
+
+int fail(const juce::String& message)
+{
+    std::cerr << "DualToneRender: " << message << "\n";
+    return 1;
+}
+
+void printParameterIds()
+{
+    std::cerr << "Parameters:";
+
+    for (const auto* parameterID : PluginState::parameterIDs)
+        std::cerr << " " << parameterID;
+
+    std::cerr << "\n";
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList arguments(argc, argv);
+
+    if (arguments.size() == 0 || arguments.containsOption("--help|-h"))
+    {
+        printUsage();
+        return arguments.size() == 0 ? 1 : 0;
+    }
+
+    OfflineRenderer::Options options;
+    juce::File outputFile;
+    juce::File stateFile;
+    juce::String format = "wav";
+    auto bitsPerSample = 24;
+    auto seconds = 0.0;
+    options.numThreads = juce::SystemStats::getNumCpus();
+    juce::Array<ParameterValue> parameterValues;
+
+    for (int index = 0; index < arguments.size(); ++index)
+    {
+        const auto option = arguments[index].text;
+
+        if (index + 1 >= arguments.size())
+            return fail("missing value for " + option);
+
+        const auto value = arguments[++index].text;
+
+        if (option == "--out")
+            outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+        else if (option == "--seconds")
+            seconds = value.getDoubleValue();
+        else if (option == "--rate")
+            options.sampleRate = value.getDoubleValue();
+        else if (option == "--channels")
+            options.numChannels = value.getIntValue();
+        else if (option == "--bits")
+            bitsPerSample = value.getIntValue();
+        else if (option == "--format")
+            format = value.toLowerCase();
+        else if (option == "--threads")
+            options.numThreads = value.getIntValue();
+        else if (option == "--state")
+            stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+        else if (option == "--set" && value.containsChar('='))
+            parameterValues.add({ value.upToFirstOccurrenceOf("=", false, false),
+                                  value.fromFirstOccurrenceOf("=", false, false).getFloatValue() });
+        else
+            return fail("unknown option " + option + " " + value);
+    }
+
+    if (outputFile == juce::File())
+        return fail("no output file given");
+    if (seconds <= 0.0 || options.sampleRate <= 0.0)
+        return fail("duration and sample rate must be positive");
+    if (options.numChannels != 1 && options.numChannels != 2)
+        return fail("only mono and stereo output is supported");
+    if (options.numThreads < 1)
+        return fail("thread count must be at least 1");
+
+    auto state = OfflineRenderer::getDefaultState();
+
+    if (stateFile != juce::File())
+    {
+        juce::MemoryBlock stateData;
+
+        if (! stateFile.loadFileAsData(stateData))
+            return fail("cannot read state file " + stateFile.getFullPathName());
+
+        // Only the binary layout is read here; open older sessions in the plugin and save them again
+        if (! state.readBinary(stateData.getData(), stateData.getSize()))
+            return fail("not a valid plugin state: " + stateFile.getFullPathName());
+    }
+
+    for (const auto& parameterValue : parameterValues)
+    {
+        const auto index = findParameter(parameterValue.id);
+
+        if (index < 0)
+        {
+            printParameterIds();
+            return fail("unknown parameter " + parameterValue.id);
+        }
+
+        state.values[static_cast<size_t>(index)] = parameterValue.value;
+    }
+
+    std::unique_ptr<juce::AudioFormat> audioFormat;
+
+    if (format == "wav")
+        audioFormat = std::make_unique<juce::WavAudioFormat>();
+    else if (format == "aiff")
+        audioFormat = std::make_unique<juce::AiffAudioFormat>();
+    else
+        return fail("unknown format " + format);
+
+    outputFile.deleteFile();
+    auto stream = outputFile.createOutputStream();
+
+    if (stream == nullptr)
+        return fail("cannot write " + outputFile.getFullPathName());
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(audioFormat->createWriterFor(stream.get(),
+                                                                                 options.sampleRate,
+                                                                                 static_cast<unsigned int>(options.numChannels),
+                                                                                 bitsPerSample,
+                                                                                 {},
+                                                                                 0));
+
+    if (writer == nullptr)
+        return fail("the " + format + " writer does not support these settings");
+
+    // The writer owns the stream from here on
+    stream.release();
+
+    options.lengthInSamples = static_cast<juce::int64>(seconds * options.sampleRate + 0.5);
+
+    const auto writeChunk = [&writer](const juce::AudioBuffer<float>& chunk, int numSamples)
+    {
+        return writer->writeFromAudioSampleBuffer(chunk, 0, numSamples);
+    };
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    if (! OfflineRenderer::render(options, state, writeChunk))
+        return fail("writing " + outputFile.getFullPathName() + " failed");
+
+    writer.reset();
+
+    const auto elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    std::cout << "Rendered " << seconds << " s to " << outputFile.getFullPathName() << " in " << elapsedSeconds << " s ("
+              << (elapsedSeconds > 0.0 ? seconds / elapsedSeconds : 0.0) << "x real time, " << options.numThreads
+              << " threads)\n";
+    return 0;
+}